@@ -44,6 +44,9 @@ $(OBJDIR)/test_data_rate.o: $(TestsDir)/test_data_rate.cpp
 $(OBJDIR)/test_debug_matches_release.o: $(TestsDir)/test_debug_matches_release.cpp
 	$(GPP) -c $(TestsDir)/test_debug_matches_release.cpp $(INCLUDE)  $(LFLAGS) -o $(OBJDIR)/test_debug_matches_release.o
 
+$(OBJDIR)/test_dec_bench_json.o: $(TestsDir)/test_dec_bench_json.cpp
+	$(GPP) -c $(TestsDir)/test_dec_bench_json.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/test_dec_bench_json.o
+
 $(OBJDIR)/test_drop_frame_watermark.o: $(TestsDir)/test_drop_frame_watermark.cpp
 	$(GPP) -c $(TestsDir)/test_drop_frame_watermark.cpp $(INCLUDE)  $(LFLAGS) -o $(OBJDIR)/test_drop_frame_watermark.o
 
@@ -140,6 +143,9 @@ $(OBJDIR)/test_thirtytwo_vs_sixtyfour.o: $(TestsDir)/test_thirtytwo_vs_sixtyfour
 $(OBJDIR)/test_two_pass_vs_two_pass_best.o: $(TestsDir)/test_two_pass_vs_two_pass_best.cpp
 	$(GPP) -c $(TestsDir)/test_two_pass_vs_two_pass_best.cpp $(INCLUDE)  $(LFLAGS) -o $(OBJDIR)/test_two_pass_vs_two_pass_best.o
 
+$(OBJDIR)/test_two_pass_webm.o: $(TestsDir)/test_two_pass_webm.cpp
+	$(GPP) -c $(TestsDir)/test_two_pass_webm.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/test_two_pass_webm.o
+
 $(OBJDIR)/test_undershoot.o: $(TestsDir)/test_undershoot.cpp
 	$(GPP) -c $(TestsDir)/test_undershoot.cpp $(INCLUDE)  $(LFLAGS) -o $(OBJDIR)/test_undershoot.o
 
@@ -161,6 +167,9 @@ $(OBJDIR)/rand_comp.o: $(ToolDir)/rand_comp.cpp
 $(OBJDIR)/graph_psnr.o: $(ToolDir)/graph_psnr.cpp
 	$(GPP) -c $(ToolDir)/graph_psnr.cpp $(INCLUDE)  $(LFLAGS) -o $(OBJDIR)/graph_psnr.o
 
+$(OBJDIR)/pareto_sweep.o: $(ToolDir)/pareto_sweep.cpp
+	$(GPP) -c $(ToolDir)/pareto_sweep.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/pareto_sweep.o
+
 $(OBJDIR)/code_coverage.o: $(ToolDir)/code_coverage.cpp
 	$(GPP) -c $(ToolDir)/code_coverage.cpp $(INCLUDE)  $(LFLAGS) -o $(OBJDIR)/code_coverage.o
 
@@ -173,6 +182,33 @@ $(OBJDIR)/md5_utils.o: $(IvfDir)/md5_utils.cpp
 $(OBJDIR)/utilities.o: $(UtlDir)/utilities.cpp
 	$(GPP) -c  $(UtlDir)/utilities.cpp $(INCLUDE)  $(LFLAGS) -o $(OBJDIR)/utilities.o
 
+$(OBJDIR)/vpxt_thread.o: $(UtlDir)/vpxt_thread.cpp
+	$(GPP) -c $(UtlDir)/vpxt_thread.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/vpxt_thread.o
+
+$(OBJDIR)/vpxt_timer.o: $(UtlDir)/vpxt_timer.cpp
+	$(GPP) -c $(UtlDir)/vpxt_timer.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/vpxt_timer.o
+
+$(OBJDIR)/vpxt_benchmark.o: $(UtlDir)/vpxt_benchmark.cpp
+	$(GPP) -c $(UtlDir)/vpxt_benchmark.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/vpxt_benchmark.o
+
+$(OBJDIR)/vpxt_scheduler.o: $(UtlDir)/vpxt_scheduler.cpp
+	$(GPP) -c $(UtlDir)/vpxt_scheduler.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/vpxt_scheduler.o
+
+$(OBJDIR)/vpxt_sweep.o: $(UtlDir)/vpxt_sweep.cpp
+	$(GPP) -c $(UtlDir)/vpxt_sweep.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/vpxt_sweep.o
+
+$(OBJDIR)/vpxt_encode_cache.o: $(UtlDir)/vpxt_encode_cache.cpp
+	$(GPP) -c $(UtlDir)/vpxt_encode_cache.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/vpxt_encode_cache.o
+
+$(OBJDIR)/vpxt_journal.o: $(UtlDir)/vpxt_journal.cpp
+	$(GPP) -c $(UtlDir)/vpxt_journal.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/vpxt_journal.o
+
+$(OBJDIR)/vpxt_json.o: $(UtlDir)/vpxt_json.cpp
+	$(GPP) -c $(UtlDir)/vpxt_json.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/vpxt_json.o
+
+$(OBJDIR)/vpxt_frame_index.o: $(UtlDir)/vpxt_frame_index.cpp
+	$(GPP) -c $(UtlDir)/vpxt_frame_index.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/vpxt_frame_index.o
+
 $(OBJDIR)/args.o: $(IvfDir)/args.cpp
 	$(GCC) -c $(IvfDir)/args.cpp $(INCLUDE) $(LFLAGS) -o $(OBJDIR)/args.o
 
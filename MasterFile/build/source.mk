@@ -23,6 +23,7 @@ SRC = \
    $(TestsDir)/test_copy_set_reference.cpp  \
    $(TestsDir)/test_data_rate.cpp  \
    $(TestsDir)/test_debug_matches_release.cpp  \
+   $(TestsDir)/test_dec_bench_json.cpp  \
    $(TestsDir)/test_drop_frame_watermark.cpp  \
    $(TestsDir)/test_encoder_break_out.cpp  \
    $(TestsDir)/test_error_concealment.cpp  \
@@ -55,6 +56,7 @@ SRC = \
    $(TestsDir)/test_test_vector.cpp  \
    $(TestsDir)/test_thirtytwo_vs_sixtyfour.cpp  \
    $(TestsDir)/test_two_pass_vs_two_pass_best.cpp  \
+   $(TestsDir)/test_two_pass_webm.cpp  \
    $(TestsDir)/test_undershoot.cpp  \
    $(TestsDir)/test_version.cpp  \
    $(TestsDir)/test_vpx_matches_int.cpp  \
@@ -62,9 +64,19 @@ SRC = \
    $(ToolDir)/run_multiple_tests.cpp \
    $(ToolDir)/rand_comp.cpp \
    $(ToolDir)/graph_psnr.cpp \
+   $(ToolDir)/pareto_sweep.cpp \
    $(ToolDir)/tools.cpp \
    $(IvfDir)/md5_utils.cpp \
    $(UtlDir)/utilities.cpp \
+   $(UtlDir)/vpxt_thread.cpp \
+   $(UtlDir)/vpxt_timer.cpp \
+   $(UtlDir)/vpxt_benchmark.cpp \
+   $(UtlDir)/vpxt_scheduler.cpp \
+   $(UtlDir)/vpxt_sweep.cpp \
+   $(UtlDir)/vpxt_encode_cache.cpp \
+   $(UtlDir)/vpxt_journal.cpp \
+   $(UtlDir)/vpxt_json.cpp \
+   $(UtlDir)/vpxt_frame_index.cpp \
    $(IvfDir)/args.cpp \
    $(IvfDir)/cpu_id.cpp \
    $(IvfDir)/EbmlWriter.cpp \
@@ -96,6 +108,7 @@ SRCOBJ = \
    $(OBJDIR)/test_copy_set_reference.o  \
    $(OBJDIR)/test_data_rate.o  \
    $(OBJDIR)/test_debug_matches_release.o  \
+   $(OBJDIR)/test_dec_bench_json.o  \
    $(OBJDIR)/test_drop_frame_watermark.o  \
    $(OBJDIR)/test_encoder_break_out.o  \
    $(OBJDIR)/test_error_concealment.o  \
@@ -128,6 +141,7 @@ SRCOBJ = \
    $(OBJDIR)/test_test_vector.o  \
    $(OBJDIR)/test_thirtytwo_vs_sixtyfour.o  \
    $(OBJDIR)/test_two_pass_vs_two_pass_best.o  \
+   $(OBJDIR)/test_two_pass_webm.o  \
    $(OBJDIR)/test_undershoot.o  \
    $(OBJDIR)/test_version.o  \
    $(OBJDIR)/test_vpx_matches_int.o  \
@@ -135,9 +149,19 @@ SRCOBJ = \
    $(OBJDIR)/run_multiple_tests.o \
    $(OBJDIR)/rand_comp.o \
    $(OBJDIR)/graph_psnr.o \
+   $(OBJDIR)/pareto_sweep.o \
    $(OBJDIR)/tools.o \
    $(OBJDIR)/md5_utils.o \
    $(OBJDIR)/utilities.o \
+   $(OBJDIR)/vpxt_thread.o \
+   $(OBJDIR)/vpxt_timer.o \
+   $(OBJDIR)/vpxt_benchmark.o \
+   $(OBJDIR)/vpxt_scheduler.o \
+   $(OBJDIR)/vpxt_sweep.o \
+   $(OBJDIR)/vpxt_encode_cache.o \
+   $(OBJDIR)/vpxt_journal.o \
+   $(OBJDIR)/vpxt_json.o \
+   $(OBJDIR)/vpxt_frame_index.o \
    $(OBJDIR)/args.o \
    $(OBJDIR)/cpu_id.o \
    $(OBJDIR)/EbmlWriter.o \
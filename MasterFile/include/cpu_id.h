@@ -19,6 +19,7 @@ extern "C" {
 // These flags are only valid on x86 processors
 static const int kCpuHasSSE2 = 1;
 static const int kCpuHasSSSE3 = 2;
+static const int kCpuHasAVX2 = 16;
 
 // These flags are only valid on ARM processors
 static const int kCpuHasNEON = 4;
@@ -0,0 +1,77 @@
+#ifndef VPXT_BENCHMARK_H_GUARD
+#define VPXT_BENCHMARK_H_GUARD
+
+// Repeated measurement of a timed run.  vpxt_bench_run runs fn warmup times
+// without keeping the result, then repetitions times keeping one sample per
+// run.  Samples further than outlier median absolute deviations from the
+// median are rejected and the median of the rest gets a bootstrap
+// confidence interval, so two benchmarks can be compared on whether their
+// difference is larger than the run to run noise.
+
+#define VPXT_BENCH_MAX_SAMPLES 64
+
+// Defaults, each can be overridden through the environment variable named
+// in vpxt_bench_config_init.
+#define VPXT_BENCH_WARMUP      1
+#define VPXT_BENCH_REPETITIONS 3
+#define VPXT_BENCH_OUTLIER     3.0
+#define VPXT_BENCH_RESAMPLES   2000
+#define VPXT_BENCH_CONFIDENCE  0.95
+
+typedef struct
+{
+    int warmup;
+    int repetitions;
+    // first processor to pin the measuring thread to, -1 to not pin
+    int cpu;
+    // processors pinned from cpu, threads the run creates share them
+    int cpu_count;
+    // rejection threshold in scaled median absolute deviations, 0 keeps all
+    double outlier;
+    int resamples;
+    double confidence;
+} VPXT_BENCH_CONFIG;
+
+typedef struct
+{
+    // every sample in run order
+    int raw_count;
+    double raw[VPXT_BENCH_MAX_SAMPLES];
+    // samples left after outlier rejection, sorted
+    int count;
+    double samples[VPXT_BENCH_MAX_SAMPLES];
+    double median;
+    // confidence interval of the median
+    double low;
+    double high;
+} VPXT_BENCH_RESULT;
+
+// Called for every run, warm up runs have a negative run index.  Stores
+// the measurement in sample and returns 0, non zero stops the benchmark.
+typedef int (*vpxt_bench_fn_t)(void *arg, int run, double *sample);
+
+// Defaults overridden by VPXT_BENCH_WARMUP, VPXT_BENCH_REPETITIONS,
+// VPXT_BENCH_CPU, VPXT_BENCH_OUTLIER, VPXT_BENCH_RESAMPLES and
+// VPXT_BENCH_CONFIDENCE when set.
+void vpxt_bench_config_init(VPXT_BENCH_CONFIG *config);
+
+void vpxt_bench_clear(VPXT_BENCH_RESULT *result);
+void vpxt_bench_add(VPXT_BENCH_RESULT *result, double sample);
+// Rejects outliers and computes median, low and high from the raw samples.
+void vpxt_bench_finish(const VPXT_BENCH_CONFIG *config,
+                       VPXT_BENCH_RESULT *result);
+
+// Returns non zero if fn failed, result then holds the runs up to it.
+int vpxt_bench_run(const VPXT_BENCH_CONFIG *config, vpxt_bench_fn_t fn,
+                   void *arg, VPXT_BENCH_RESULT *result);
+
+// Confidence interval of test's median relative to base's, as the fraction
+// test / base - 1, in low and high.  Returns -1 when test is significantly
+// lower, 1 when it is significantly higher and 0 when the interval spans
+// no difference.
+int vpxt_bench_compare(const VPXT_BENCH_CONFIG *config,
+                       const VPXT_BENCH_RESULT *base,
+                       const VPXT_BENCH_RESULT *test,
+                       double *low, double *high);
+
+#endif
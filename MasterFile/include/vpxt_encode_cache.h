@@ -0,0 +1,42 @@
+#ifndef VPXT_ENCODE_CACHE_H_GUARD
+#define VPXT_ENCODE_CACHE_H_GUARD
+
+// Content addressed store of encode results.  An entry is keyed by the md5
+// of the source file and a text describing everything else the encode
+// depends on, and holds the output, its side files and the metrics text
+// measured while it was produced.  Files of an entry are kept as
+// <key>.<name> in the directory named by VPXT_ENCODE_CACHE, the cache is
+// off when it is not set.  Once the directory grows past
+// VPXT_ENCODE_CACHE_MB megabytes the least recently used entries are
+// removed.
+//
+// Entries are written under temporary names and only become visible once
+// complete, so processes running side by side can share one cache.
+
+#include <string>
+
+#define VPXT_ENCODE_CACHE_MB 4096
+
+// Directory of the cache, NULL when it is off.
+const char *vpxt_encode_cache_dir();
+
+// key gets 32 hex digits.  Returns -1 if the source can not be read.
+int vpxt_encode_cache_key(const char *source, const std::string &config,
+                          char key[33]);
+
+// Copies file names[i] of entry key to paths[i] for each of the count
+// files, a NULL path is skipped.  metrics gets the stored metrics text.
+// Returns -1, having copied nothing, unless the entry has every file.
+int vpxt_encode_cache_fetch(const char *key, int count,
+                            const char *const *names,
+                            const char *const *paths, std::string *metrics);
+
+// Stores paths[i] as file names[i] of entry key, a NULL path or a missing
+// file is left out of the entry.  Returns -1 if the entry could not be
+// written.
+int vpxt_encode_cache_store(const char *key, int count,
+                            const char *const *names,
+                            const char *const *paths,
+                            const std::string &metrics);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef VPXT_FRAME_INDEX_H_GUARD
+#define VPXT_FRAME_INDEX_H_GUARD
+
+// Index of the frames of a compressed file, so the tools that look at every
+// frame of an output answer from it instead of scanning the file again.  It
+// is kept next to the file as <file>.idx together with the size and
+// modification time of the file it was built from, and ignored once those
+// no longer match.
+
+#include "vpx_integer.h"
+#include <vector>
+
+#define VPXT_FRAME_KEY    0x01
+#define VPXT_FRAME_SHOW   0x02
+// frames that are decoded but not shown, such as alt ref frames
+#define VPXT_FRAME_ALTREF 0x04
+
+typedef struct
+{
+    // position of the frame data in the file
+    uint64_t offset;
+    uint64_t pts;
+    uint32_t size;
+    // fields of the VP8 frame tag
+    uint32_t first_part_size;
+    uint8_t flags;
+    uint8_t version;
+    // coded size, key frames only
+    uint16_t width;
+    uint16_t height;
+} VPXT_FRAME_INDEX_ENTRY;
+
+typedef struct
+{
+    // file_kind of the file
+    int kind;
+    unsigned int fourcc;
+    unsigned int width;
+    unsigned int height;
+    // frame rate as read by the decode tools
+    unsigned int fps_num;
+    unsigned int fps_den;
+    // frame count of the IVF file header, 0 for other files
+    unsigned int header_length;
+    std::vector<VPXT_FRAME_INDEX_ENTRY> frames;
+} VPXT_FRAME_INDEX;
+
+// Returns -1 if file has no current index.
+int vpxt_frame_index_load(const char *file, VPXT_FRAME_INDEX *index);
+// Returns -1 if the index could not be written.
+int vpxt_frame_index_save(const char *file, const VPXT_FRAME_INDEX *index);
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef VPXT_FRAME_SCAN_H_GUARD
+#define VPXT_FRAME_SCAN_H_GUARD
+
+// Analyses of a compressed file that the checkers used to run as separate
+// passes over it.  A test registers the analyses it needs and gets all of
+// their results from a single walk of the file's frame index.
+
+#include "vpx_integer.h"
+#include <vector>
+
+#define VPXT_SCAN_DATA_RATE      0x001
+#define VPXT_SCAN_PBM            0x002
+#define VPXT_SCAN_PBM_THRESHOLD  0x004
+#define VPXT_SCAN_KEY_FRAMES     0x008
+#define VPXT_SCAN_RESIZED        0x010
+#define VPXT_SCAN_VISIBLE        0x020
+#define VPXT_SCAN_ALT_REF        0x040
+#define VPXT_SCAN_DROPPED        0x080
+// what vpxt_frame_scan_dfwm_check reads
+#define VPXT_SCAN_DFWM (VPXT_SCAN_KEY_FRAMES | VPXT_SCAN_RESIZED | \
+                        VPXT_SCAN_PBM_THRESHOLD)
+
+typedef struct
+{
+    int frame;
+    unsigned int width;
+    unsigned int height;
+} VPXT_SCAN_RESIZE;
+
+typedef struct
+{
+    // VPXT_SCAN_ analyses to run
+    int analyses;
+
+    // buffer model of the pbm analyses, bit rate in kbps and buffer levels
+    // in ms
+    double bitrate;
+    int64_t max_buffer;
+    int64_t pre_buffer;
+    int64_t optimal_buffer;
+    // percent of the optimal buffer level a frame counts as under
+    int threshold;
+
+    int frame_count;
+    // in kb/s
+    double data_rate_avg;
+    double data_rate_min;
+    double data_rate_max;
+    double data_rate_file;
+    // first frame the buffer underruns at, -11 if it never does
+    int pbm_underrun;
+    // 1 for each frame the buffer is under the threshold after
+    std::vector<char> pbm_under_threshold;
+    std::vector<int> key_frames;
+    // shown frames whose size differs from the file header
+    std::vector<VPXT_SCAN_RESIZE> resized_frames;
+    std::vector<int> visible_frames;
+    std::vector<int> alt_ref_frames;
+    // frame before each gap in the time stamps, once per missing frame
+    std::vector<int> dropped_frames;
+} VPXT_FRAME_SCAN;
+
+void vpxt_frame_scan_init(VPXT_FRAME_SCAN *scan, int analyses);
+// Returns -1 if the file can't be opened and EXIT_FAILURE if it isn't a
+// compressed file.
+int vpxt_frame_scan(const char *input_file, VPXT_FRAME_SCAN *scan);
+// Writes the text files the display and check tools write next to
+// input_file for each registered analysis.  Returns -1 if one of them
+// could not be opened.
+int vpxt_frame_scan_write(const char *input_file, const VPXT_FRAME_SCAN *scan);
+
+// Both return 0 on pass and 1 on fail.  dfwm also returns -3 if the buffer
+// never reached the threshold.
+int vpxt_frame_scan_dfwm_check(const VPXT_FRAME_SCAN *scan, int printselect);
+int vpxt_frame_scan_force_key_check(const VPXT_FRAME_SCAN *scan,
+                                    int interval);
+
+#endif
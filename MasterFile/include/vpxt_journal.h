@@ -0,0 +1,72 @@
+#ifndef VPXT_JOURNAL_H_GUARD
+#define VPXT_JOURNAL_H_GUARD
+
+// Append only record of a multiple test run, one JSON object per line:
+//
+//   {"event":"run","mode":1}
+//   {"event":"start","test":3,"name":"test_speed","folder":"..."}
+//   {"event":"artifact","test":3,"key":"...","output":"...","metrics":"..."}
+//   {"event":"end","test":3,"result":1}
+//   {"event":"done"}
+//
+// Every record is written with a single write and flushed to disk before
+// the call returns, so a run that is killed leaves at most a torn last
+// line, which loading skips.  Resume loads the journal instead of parsing
+// the summary text, and encodes a test completed before it was interrupted
+// are taken from their artifact records instead of being run again.
+
+#include <string>
+#include <vector>
+
+typedef struct
+{
+    std::string name;
+    std::string folder;
+    // result of the test once it ended, -1 until then
+    int result;
+} VPXT_JOURNAL_TEST;
+
+typedef struct
+{
+    int test;
+    // vpxt_encode_cache_key of the encode
+    std::string key;
+    std::string output;
+    std::string metrics;
+} VPXT_JOURNAL_ARTIFACT;
+
+typedef struct
+{
+    // mode of the run, -1 without a run record
+    int mode;
+    int done;
+    // indexed by test number
+    std::vector<VPXT_JOURNAL_TEST> tests;
+    std::vector<VPXT_JOURNAL_ARTIFACT> artifacts;
+} VPXT_JOURNAL;
+
+// Returns -1 if the journal can not be opened.
+int vpxt_journal_load(const char *path, VPXT_JOURNAL *journal);
+
+// Each returns -1 if the record could not be written.
+int vpxt_journal_write_run(const char *path, int mode);
+int vpxt_journal_write_start(const char *path, int test,
+                             const std::string &name,
+                             const std::string &folder);
+int vpxt_journal_write_end(const char *path, int test, int result);
+int vpxt_journal_write_done(const char *path);
+
+// Journal and test number artifacts of the encodes of the test running in
+// this process are recorded under, a NULL path stops recording.
+void vpxt_journal_set_current(const char *path, int test);
+int vpxt_journal_recording();
+void vpxt_journal_add_artifact(const char *key, const char *output,
+                               const std::string &metrics);
+
+// Artifacts of an interrupted run that encodes can be taken from, the
+// journal has to stay valid while it is set.
+void vpxt_journal_set_resume(const VPXT_JOURNAL *journal);
+// Latest artifact with key, NULL if there is none.
+const VPXT_JOURNAL_ARTIFACT *vpxt_journal_find_artifact(const char *key);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef VPXT_JSON_H_GUARD
+#define VPXT_JSON_H_GUARD
+
+// Writing and reading of the flat one line JSON objects the journal and
+// the decoder benchmark record, strings and numbers only.
+
+#include <string>
+#include <vector>
+
+// Appends value to out as a quoted JSON string.
+void vpxt_json_string(std::string &out, const std::string &value);
+// Parses the quoted JSON string starting at line[*pos] into value and
+// moves *pos past it.  Returns -1 if it is malformed.
+int vpxt_json_parse_string(const std::string &line, size_t *pos,
+                           std::string &value);
+// Fields of a one line object in names and values, numbers are kept as
+// text.  Returns -1 for a torn or malformed line.
+int vpxt_json_parse_record(const std::string &line,
+                           std::vector<std::string> &names,
+                           std::vector<std::string> &values);
+// Value of field name, NULL if the record does not have it.
+const std::string *vpxt_json_field(const std::vector<std::string> &names,
+                                   const std::vector<std::string> &values,
+                                   const char *name);
+
+#endif
@@ -0,0 +1,164 @@
+#include "yv12config.h"
+#include "vpx_integer.h"
+#include "vpxt_thread.h"
+
+#ifndef PSNR_H_GUARD
+#define PSNR_H_GUARD
+
+// Sum of squared error kernel over a width x height block of 8 bit samples.
+// Every implementation must return exactly the same value as vpxt_sse_c.
+typedef uint64_t (*vpxt_sse_fn_t)(const unsigned char *src, int src_stride,
+                                  const unsigned char *dst, int dst_stride,
+                                  int width, int height);
+
+enum SseKernelType{
+    kSseKernelC = 0,
+    kSseKernelSSE2 = 1,
+    kSseKernelAVX2 = 2,
+    kSseKernelNEON = 3,
+    kSseKernelCount = 4
+};
+
+uint64_t vpxt_sse_c(const unsigned char *src, int src_stride,
+                    const unsigned char *dst, int dst_stride,
+                    int width, int height);
+vpxt_sse_fn_t vpxt_sse_kernel(int kernel_type);
+const char *vpxt_sse_kernel_name(int kernel_type);
+vpxt_sse_fn_t vpxt_sse_select_kernel();
+uint64_t vpxt_sse(const unsigned char *src, int src_stride,
+                  const unsigned char *dst, int dst_stride,
+                  int width, int height);
+
+#define VPXT_MAX_SEGMENTS 16
+
+// Squared error totals for one frame.  When run_artifact is set the Y plane
+// total is also kept per segment for artifact detection.  ssim and
+// ssim_weight are only filled in by vpxt_calc_frame_metrics.
+typedef struct
+{
+    uint64_t sse[3];
+
+    int run_artifact;
+    int width_segments;
+    int height_segments;
+    int segment_width;
+    int segment_height;
+    uint64_t segment_sse[VPXT_MAX_SEGMENTS][VPXT_MAX_SEGMENTS];
+
+    double ssim;
+    double ssim_weight;
+} VPXT_FRAME_METRICS;
+
+void vpxt_init_frame_metrics(YV12_BUFFER_CONFIG *source, int run_artifact,
+                             VPXT_FRAME_METRICS *metrics);
+void vpxt_add_luma_sse(const VPXT_FRAME_METRICS *metrics,
+                       const unsigned char *src, int src_stride,
+                       const unsigned char *dst, int dst_stride,
+                       int width, int row, int rows, uint64_t *sse,
+                       uint64_t segment_sse[][VPXT_MAX_SEGMENTS]);
+void vpxt_frame_sse(YV12_BUFFER_CONFIG *source, YV12_BUFFER_CONFIG *dest,
+                    VPXT_FRAME_METRICS *metrics);
+double vpxt_psnr_from_metrics(YV12_BUFFER_CONFIG *source,
+                              const VPXT_FRAME_METRICS *metrics,
+                              double *ypsnr, double *upsnr, double *vpsnr,
+                              double *sq_error, int print_out,
+                              int& possible_artifact);
+
+double vp8_mse_2_psnr_tester(double samples, double peak, double mse);
+double vp8_calcpsnr_tester(YV12_BUFFER_CONFIG *source,
+                           YV12_BUFFER_CONFIG *dest,
+                           double *ypsnr,
+                           double *upsnr,
+                           double *vpsnr,
+                           double *sq_error,
+                           int print_out,
+                           int& possible_artifact);
+// Scratch for one horizontal band of an SSIM plane.
+typedef struct
+{
+    short *img1_sum;
+    short *img2_sum;
+    int *img1_sq_sum;
+    int *img2_sq_sum;
+    int *img12_mul_sum;
+
+    int *block1;
+    int *block2;
+    int *block11;
+    int *block22;
+    int *block12;
+    double *similarity;
+
+    double quality;
+    double summed_weights;
+
+    // squared error of the rows this band owns
+    int *col_sse;
+    uint64_t sse;
+    uint64_t segment_sse[VPXT_MAX_SEGMENTS][VPXT_MAX_SEGMENTS];
+} VPXT_SSIM_BAND;
+
+// Per caller SSIM state.  Holds the scratch buffers and per plane settings
+// that used to live in file statics so several frames can be measured at
+// once.  Zero with vpxt_ssim_ctx_init and release with vpxt_ssim_ctx_free.
+//
+// Setting pool (before the first frame) splits every plane into horizontal
+// bands that are measured in parallel.  With a single band the results are
+// bit identical to the scalar code regardless of kernel_type.  With several
+// bands each band sums its own windows and the band totals are added at the
+// end, so results may differ from the single band value in the last bits
+// (relative difference below 1e-12).
+typedef struct
+{
+    int alloc_width;
+    int alloc_height;
+    int alloc_height_uv;
+    int width_uv;
+    int lumimask;
+    int luminance;
+    int kernel_type;
+    double plane_summed_weights;
+
+    short *img12_sum_block;
+    unsigned char *zero_row;
+
+    VPXT_WORKER_POOL *pool;
+    int band_count;
+    VPXT_SSIM_BAND *bands;
+} VPXT_SSIM_CTX;
+
+void vpxt_ssim_ctx_init(VPXT_SSIM_CTX *ctx);
+int vpxt_ssim_ctx_alloc(VPXT_SSIM_CTX *ctx, int width, int height,
+                        int width_uv, int height_uv);
+void vpxt_ssim_ctx_free(VPXT_SSIM_CTX *ctx);
+double vpxt_calc_ssim(VPXT_SSIM_CTX *ctx,
+                      YV12_BUFFER_CONFIG *source,
+                      YV12_BUFFER_CONFIG *dest,
+                      int lumamask,
+                      double *weight);
+double vpxt_calc_ssimg(VPXT_SSIM_CTX *ctx,
+                       YV12_BUFFER_CONFIG *source,
+                       YV12_BUFFER_CONFIG *dest,
+                       double *ssim_y,
+                       double *ssim_u,
+                       double *ssim_v);
+// Fused per frame metrics: squared error (per segment when run_artifact is
+// set) is gathered while the SSIM passes walk each row, so a frame is read
+// once instead of once for SSIM and again for PSNR.  Pass the result to
+// vpxt_psnr_from_metrics for the PSNR values.
+void vpxt_calc_frame_metrics(VPXT_SSIM_CTX *ctx,
+                             YV12_BUFFER_CONFIG *source,
+                             YV12_BUFFER_CONFIG *dest,
+                             int run_ssim,
+                             int run_artifact,
+                             VPXT_FRAME_METRICS *metrics);
+double VP8_CalcSSIM_Tester(YV12_BUFFER_CONFIG *source,
+                           YV12_BUFFER_CONFIG *dest,
+                           int lumamask,
+                           double *weight);
+double vp8_calc_ssimg(YV12_BUFFER_CONFIG *source,
+                      YV12_BUFFER_CONFIG *dest,
+                      double *ssim_y,
+                      double *ssim_u,
+                      double *ssim_v);
+#endif
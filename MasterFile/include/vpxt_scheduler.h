@@ -0,0 +1,78 @@
+#ifndef VPXT_SCHEDULER_H_GUARD
+#define VPXT_SCHEDULER_H_GUARD
+
+// Runs tasks side by side in child processes so each one has its own
+// stdio, working state and crash domain.  At most workers tasks run at a
+// time and an exclusive task only runs with nothing else running, for
+// tasks that time themselves.  Where processes can not be forked every
+// task runs inline in vpxt_sched_start, one at a time.
+//
+//   while (!vpxt_sched_can_start(&sched, exclusive))
+//       vpxt_sched_wait(&sched, &job, &result);
+//   vpxt_sched_start(&sched, job, exclusive, output, fn, arg);
+
+#include "vpx_integer.h"
+
+#if !defined(_WIN32)
+#include <sys/types.h>
+#endif
+
+// The task's return value is its result, handed back through a pipe so
+// any int can be returned.
+typedef int (*vpxt_task_fn_t)(void *arg);
+
+// Results of a task that did not return normally.
+#define VPXT_TASK_CRASHED       -1
+#define VPXT_TASK_EXITED        -2
+#define VPXT_TASK_TIMED_OUT     -3
+#define VPXT_TASK_OUT_OF_MEMORY -4
+
+typedef struct
+{
+    int job;
+    int exclusive;
+    int result;
+    // 0 once the task has finished or when it ran inline
+#if defined(_WIN32)
+    int pid;
+#else
+    pid_t pid;
+#endif
+    int result_pipe;
+    uint64_t start_time;
+    // result to report instead once a killed task is reaped
+    int killed;
+} VPXT_TASK;
+
+typedef struct
+{
+    int workers;
+    int running;
+    int exclusive;
+    // limits of every task, 0 for none
+    uint64_t timeout_us;
+    uint64_t rss_limit;
+    VPXT_TASK *tasks;
+} VPXT_SCHEDULER;
+
+// workers below 1 uses VPXT_TEST_WORKERS when set, otherwise one worker
+// per processor.  VPXT_TEST_TIMEOUT in seconds and VPXT_TEST_RSS_LIMIT in
+// megabytes set the limits.
+int vpxt_sched_init(VPXT_SCHEDULER *sched, int workers);
+void vpxt_sched_destroy(VPXT_SCHEDULER *sched);
+
+int vpxt_sched_running(const VPXT_SCHEDULER *sched);
+int vpxt_sched_can_start(const VPXT_SCHEDULER *sched, int exclusive);
+// job is handed back by vpxt_sched_wait.  When output is set the task's
+// stdout and stderr are redirected to that file.  Returns -1 if there is
+// no free worker for the task.
+int vpxt_sched_start(VPXT_SCHEDULER *sched, int job, int exclusive,
+                     const char *output, vpxt_task_fn_t fn, void *arg);
+// Blocks until a task finishes, killing tasks past their limits.  Returns
+// -1 if none is running.
+int vpxt_sched_wait(VPXT_SCHEDULER *sched, int *job, int *result);
+
+// Name of a VPXT_TASK_ result, NULL for a normal result.
+const char *vpxt_sched_result_name(int result);
+
+#endif
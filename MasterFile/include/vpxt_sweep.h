@@ -0,0 +1,57 @@
+#ifndef VPXT_SWEEP_H_GUARD
+#define VPXT_SWEEP_H_GUARD
+
+#include "vpxt_thread.h"
+
+// Runs the independent encode and metric jobs of a sweep test side by side
+// on a worker pool.  vpxt_sweep_run calls fn(arg, job) for every job and
+// returns once all of them are done, with tprintf output of each job
+// printed in job order so logs read as if the jobs ran one after another.
+//
+// Timed encodes and decodes open a timed section around what they measure.
+// While one is open no other job of the sweep runs, so timings are taken
+// on an otherwise idle process; jobs waiting for a timed section keep new
+// jobs from starting.
+typedef int (*vpxt_sweep_fn_t)(void *arg, int job);
+
+typedef struct
+{
+    VPXT_WORKER_POOL pool;
+    vpxt_mutex_t lock;
+    vpxt_cond_t changed;
+    // jobs running outside a timed section
+    int running;
+    int timing;
+    int timing_waiting;
+
+    // current vpxt_sweep_run
+    vpxt_sweep_fn_t fn;
+    void *arg;
+    int *results;
+    int job_count;
+    int *done;
+    // VPXT_PRINT_CAPTURE of every job when jobs run side by side
+    void *captures;
+    int next_print;
+} VPXT_SWEEP;
+
+// threads below 1 uses VPXT_SWEEP_THREADS when set, otherwise one thread
+// per processor.  1 runs every job inline.
+int vpxt_sweep_init(VPXT_SWEEP *sweep, int threads);
+void vpxt_sweep_destroy(VPXT_SWEEP *sweep);
+
+// results, if not NULL, gets the value fn returned for every job.
+void vpxt_sweep_run(VPXT_SWEEP *sweep, vpxt_sweep_fn_t fn, void *arg,
+                    int job_count, int *results);
+
+// Threads the sweep the calling thread runs a job of works with, 0 outside
+// a sweep job.  Work a job would spread over threads of its own is better
+// kept on the job's thread when this is above 1.
+int vpxt_sweep_job_threads();
+
+// Used by the timed functions themselves, nested sections are part of the
+// outermost one.  Outside a sweep job they do nothing.
+void vpxt_timed_section_begin();
+void vpxt_timed_section_end();
+
+#endif
@@ -64,5 +64,6 @@ enum TestResultTypes {
     kTestEncCreated = 10,       // compression made
     kTestErrFileMismatch = 11,  // error file mismatch
     kTestNotSupported = 12,     // test not supported
-    kTestPossibleArtifact = 13  // possible artifact
+    kTestPossibleArtifact = 13, // possible artifact
+    kTestCrashed = 14           // test worker crashed, exited or was killed
 };
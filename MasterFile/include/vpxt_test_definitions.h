@@ -50,8 +50,10 @@ kTestTwoPassVsTwoPassBest = 44,  // test_two_pass_vs_two_pass_best
 kTestUndershoot = 45,            // test_undershoot
 kTestVersion = 46,               // test_version
 kTestVpxMatchesInt = 47,         // test_vpx_matches_int
-kTestWinLinMacMatch = 48         // test_win_lin_mac_match
+kTestWinLinMacMatch = 48,        // test_win_lin_mac_match
+kTestDecBenchJson = 49,          // test_dec_bench_json
+kTestTwoPassWebm = 50            // test_two_pass_webm
 };
 #endif
 
-#define MAXTENUM 48
+#define MAXTENUM 50
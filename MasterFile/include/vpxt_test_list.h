@@ -349,6 +349,20 @@ int test_win_lin_mac_match(int argc,
                                   int test_type,
                                   int delete_ivf_files,
                                   int artifact_detection);
+int test_dec_bench_json(int argc,
+                               const char** argv,
+                               const std::string &working_dir,
+                               const std::string sub_folder_str,
+                               int test_type,
+                               int delete_ivf_files,
+                               int artifact_detection);
+int test_two_pass_webm(int argc,
+                              const char** argv,
+                              const std::string &working_dir,
+                              const std::string sub_folder_str,
+                              int test_type,
+                              int delete_ivf_files,
+                              int artifact_detection);
 
 //Tools
 int tool_rand_comp(int argc,
@@ -0,0 +1,134 @@
+#ifndef VPXT_THREAD_H_GUARD
+#define VPXT_THREAD_H_GUARD
+
+// Minimal portable threading layer.  Win32 builds use native threads,
+// critical sections and condition variables (Vista or newer), everything
+// else uses pthreads.
+
+#if defined(_WIN32)
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600
+#endif
+#include <windows.h>
+typedef HANDLE vpxt_thread_t;
+typedef CRITICAL_SECTION vpxt_mutex_t;
+typedef CONDITION_VARIABLE vpxt_cond_t;
+#else
+#include <pthread.h>
+typedef pthread_t vpxt_thread_t;
+typedef pthread_mutex_t vpxt_mutex_t;
+typedef pthread_cond_t vpxt_cond_t;
+#endif
+
+#if defined(_WIN32)
+typedef INIT_ONCE vpxt_once_t;
+#define VPXT_ONCE_INIT INIT_ONCE_STATIC_INIT
+#else
+typedef pthread_once_t vpxt_once_t;
+#define VPXT_ONCE_INIT PTHREAD_ONCE_INIT
+#endif
+
+// Storage class of variables with a copy per thread.
+#if defined(_MSC_VER)
+#define VPXT_THREAD_LOCAL __declspec(thread)
+#else
+#define VPXT_THREAD_LOCAL __thread
+#endif
+
+typedef void *(*vpxt_thread_fn_t)(void *arg);
+
+int vpxt_thread_create(vpxt_thread_t *thread, vpxt_thread_fn_t fn, void *arg);
+int vpxt_thread_join(vpxt_thread_t thread);
+
+void vpxt_mutex_init(vpxt_mutex_t *mutex);
+void vpxt_mutex_destroy(vpxt_mutex_t *mutex);
+void vpxt_mutex_lock(vpxt_mutex_t *mutex);
+void vpxt_mutex_unlock(vpxt_mutex_t *mutex);
+
+void vpxt_cond_init(vpxt_cond_t *cond);
+void vpxt_cond_destroy(vpxt_cond_t *cond);
+void vpxt_cond_wait(vpxt_cond_t *cond, vpxt_mutex_t *mutex);
+void vpxt_cond_signal(vpxt_cond_t *cond);
+void vpxt_cond_broadcast(vpxt_cond_t *cond);
+
+// Calls fn the first time any thread passes once, a statically initialised
+// VPXT_ONCE_INIT, and makes every other caller wait until it has returned.
+void vpxt_once(vpxt_once_t *once, void (*fn)());
+
+// Number of logical processors available to the process, at least 1.
+int vpxt_cpu_count();
+
+// Restricts the calling thread, and threads it creates afterwards, to
+// cpu_count processors starting at first_cpu.  A negative first_cpu allows
+// every processor again.  Returns -1 where affinity is not supported.
+int vpxt_thread_pin(int first_cpu, int cpu_count);
+
+// Affinity of a thread, saved before pinning it so it can be put back
+// afterwards instead of widening it to every processor.
+typedef struct
+{
+#if defined(_WIN32)
+    DWORD_PTR mask;
+#elif defined(linux) || defined(__linux__)
+    cpu_set_t set;
+#endif
+    int saved;
+} VPXT_AFFINITY;
+
+// Both return -1 where affinity is not supported.  Restoring an affinity
+// that could not be saved leaves the thread as it is.
+int vpxt_thread_affinity_save(VPXT_AFFINITY *affinity);
+int vpxt_thread_affinity_restore(const VPXT_AFFINITY *affinity);
+
+// Fixed size worker pool for data parallel loops.  vpxt_pool_run calls
+// fn(arg, job) once for every job in [0, job_count) and returns when all of
+// them have finished.  The calling thread works on jobs as well, so a pool
+// created with zero threads simply runs every job inline.  Only one
+// vpxt_pool_run may be active on a pool at a time.
+typedef void (*vpxt_job_fn_t)(void *arg, int job);
+
+typedef struct
+{
+    int thread_count;
+    vpxt_thread_t *threads;
+    vpxt_mutex_t lock;
+    vpxt_cond_t work_ready;
+    vpxt_cond_t work_done;
+
+    vpxt_job_fn_t fn;
+    void *arg;
+    int job_count;
+    int next_job;
+    int jobs_running;
+    int generation;
+    int shutdown;
+} VPXT_WORKER_POOL;
+
+int vpxt_pool_create(VPXT_WORKER_POOL *pool, int thread_count);
+void vpxt_pool_run(VPXT_WORKER_POOL *pool, vpxt_job_fn_t fn, void *arg,
+                   int job_count);
+void vpxt_pool_destroy(VPXT_WORKER_POOL *pool);
+
+// Bounded FIFO of pointers for handing work between pipeline stages.
+// vpxt_queue_push blocks while the queue is full and vpxt_queue_pop while it
+// is empty.  After vpxt_queue_close both return -1 straight away so blocked
+// stages can be shut down.
+typedef struct
+{
+    void **items;
+    int capacity;
+    int head;
+    int count;
+    int closed;
+    vpxt_mutex_t lock;
+    vpxt_cond_t not_empty;
+    vpxt_cond_t not_full;
+} VPXT_QUEUE;
+
+int vpxt_queue_init(VPXT_QUEUE *queue, int capacity);
+int vpxt_queue_push(VPXT_QUEUE *queue, void *item);
+int vpxt_queue_pop(VPXT_QUEUE *queue, void **item);
+void vpxt_queue_close(VPXT_QUEUE *queue);
+void vpxt_queue_destroy(VPXT_QUEUE *queue);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef VPXT_TIMER_H_GUARD
+#define VPXT_TIMER_H_GUARD
+
+#include "vpx_integer.h"
+
+// 64 bit timing, all values in microseconds.  Wall time is monotonic so it
+// does not jump with clock changes.  Thread cpu time only counts the calling
+// thread while process cpu time counts user and system time of every thread
+// in the process, so for a multithreaded codec the two differ.
+uint64_t vpxt_wall_time_us();
+uint64_t vpxt_thread_cpu_time_us();
+uint64_t vpxt_process_cpu_time_us();
+
+// Snapshot of all three clocks for timing a section of code:
+//
+//   VPXT_TIMES start;
+//   vpxt_times_now(&start);
+//   ...
+//   vpxt_times_add_since(&total, &start);
+typedef struct
+{
+    uint64_t wall;
+    uint64_t thread_cpu;
+    uint64_t process_cpu;
+} VPXT_TIMES;
+
+void vpxt_times_clear(VPXT_TIMES *times);
+void vpxt_times_now(VPXT_TIMES *times);
+void vpxt_times_add_since(VPXT_TIMES *total, const VPXT_TIMES *start);
+
+// HDR style latency histogram in microseconds.  Values below 64 are counted
+// exactly, larger ones in 32 buckets per power of two so a reported
+// percentile is never more than about 3% above the true value, over the
+// whole 64 bit range with a fixed size table and no allocation.
+#define VPXT_LATENCY_EXACT    64
+#define VPXT_LATENCY_SUB      32
+#define VPXT_LATENCY_BUCKETS  (VPXT_LATENCY_EXACT + 58 * VPXT_LATENCY_SUB)
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[VPXT_LATENCY_BUCKETS];
+} VPXT_LATENCY_HISTOGRAM;
+
+void vpxt_latency_clear(VPXT_LATENCY_HISTOGRAM *hist);
+void vpxt_latency_add(VPXT_LATENCY_HISTOGRAM *hist, uint64_t value);
+// Smallest bucket value that at least percentile (0 - 100) percent of the
+// values are at or below, capped to the largest value seen.  0 when empty.
+uint64_t vpxt_latency_percentile(const VPXT_LATENCY_HISTOGRAM *hist,
+                                 double percentile);
+uint64_t vpxt_latency_mean(const VPXT_LATENCY_HISTOGRAM *hist);
+
+#endif
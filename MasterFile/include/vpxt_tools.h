@@ -16,6 +16,7 @@ int tool_compare_enc(int argc, const char** argv);
 int tool_compare_dec(int argc, const char** argv);
 int tool_compare_code_coverage(int argc, const char** argv);
 int tool_compare_header_info(int argc, const char** argv);
+int tool_dec_bench(int argc, const char** argv);
 int tool_display_header_info(int argc, const char** argv);
 int tool_compression_equiv(int argc, const char** argv,
                            std::string working_dir);
@@ -56,9 +57,11 @@ int tool_vpxt_psnr_run_dec(int argc, const char** argv);
 int tool_formatted_to_raw(int argc, const char** argv);
 int tool_formatted_to_raw_frames(int argc, const char** argv);
 int tool_paste_clip(int argc, const char** argv);
+int tool_pareto_sweep(int argc, const char** argv);
 int tool_play_comp_ivf(int argc, const char** argv);
 int tool_play_dec_ivf(int argc, const char** argv);
 int tool_print_cpu_info();
+int tool_psnr_kernel_bench(int argc, const char** argv);
 int tool_random_stress_test(int argc, const char** argv);
 int tool_raw_to_formatted(int argc, const char** argv);
 int tool_run_ivfdec(int argc, const char** argv);
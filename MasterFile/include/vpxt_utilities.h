@@ -1,5 +1,6 @@
 #include "onyx.h"
 #include "ivf.h"
+#include "vpxt_benchmark.h"
 #include <string>
 #include <vector>
 
@@ -37,7 +38,38 @@ enum SetConfig{
     kSetConfigOff = 2
 };
 
+// Per frame latency of the timed encodes and decodes is kept for all frames
+// and by frame type.  Encoder calls that return no frame, because the frame
+// was dropped or is still held back by lag, count as dropped.
+enum LatencyFrameType{
+    kLatencyAll = 0,
+    kLatencyKeyFrame = 1,
+    kLatencyAltRef = 2,
+    kLatencyInterFrame = 3,
+    kLatencyDropped = 4,
+    kLatencyFrameTypes = 5
+};
+
+// What one benchmark run of a timed encode or decode is measured by.
+enum BenchMetric{
+    kBenchTime = 0,
+    kBenchCpuTick = 1,
+    kBenchLatencyP99 = 2
+};
+
 void tprintf(int PrintSelection, const char *fmt, ...);
+// While a capture is set, tprintf output of the calling thread is kept in
+// it instead of printed, so jobs running side by side can be printed in
+// order once they are done.  NULL prints straight away again.
+typedef struct
+{
+    std::string std_out;
+    std::string std_err;
+} VPXT_PRINT_CAPTURE;
+
+void vpxt_print_capture_set(VPXT_PRINT_CAPTURE *capture);
+// Prints and empties capture.
+void vpxt_print_capture_flush(VPXT_PRINT_CAPTURE *capture);
 std::string slashCharStr();
 char slashChar();
 //-----------------------------VP8 Settings-------------------------------------
@@ -141,6 +173,28 @@ int vpxt_find_non_ignored_files_in_dir(std::vector<std::string> IgnoredFiles,
                                        std::vector<std::string> &FilesFound,
                                        std::string directory);
 //---------------------------IVF------------------------------------------------
+// Frame buffers reused across frames and keyed by geometry.
+// vpxt_frame_pool_get returns a free buffer of the requested size and only
+// allocates when none is free, vpxt_frame_pool_put hands it back.  Chroma
+// planes are (1 + size) / 2 like image2yuvconfig.  Not thread safe.
+typedef struct vpxt_pool_frame
+{
+    YV12_BUFFER_CONFIG yv12;
+    int in_use;
+    struct vpxt_pool_frame *next;
+} VPXT_POOL_FRAME;
+
+typedef struct
+{
+    int border;
+    VPXT_POOL_FRAME *frames;
+} VPXT_FRAME_POOL;
+
+void vpxt_frame_pool_init(VPXT_FRAME_POOL *pool, int border);
+YV12_BUFFER_CONFIG *vpxt_frame_pool_get(VPXT_FRAME_POOL *pool, int width,
+                                        int height);
+void vpxt_frame_pool_put(VPXT_FRAME_POOL *pool, YV12_BUFFER_CONFIG *yv12);
+void vpxt_frame_pool_free(VPXT_FRAME_POOL *pool);
 int image2yuvconfig(const vpx_image_t   *img, YV12_BUFFER_CONFIG  *yv12);
 double vpxt_psnr(const char *inputFile1,
                  const char *inputFile2,
@@ -219,6 +273,24 @@ void vpxt_cap_string_print(int selector, const char *fmt, ...);
 int  vpxt_lower_case_string(std::string &input);
 //------------------------------IVF API-----------------------------------------
 #ifdef API
+// PSNR of an encode measured in process.  Passed to vpxt_compress or
+// vpxt_time_compress the frames of the final pass are decoded and compared
+// to the source as they are produced instead of reading the output back
+// with vpxt_psnr afterwards.  Output and results match vpxt_psnr on an ivf
+// output file.  potential_artifact is used as vpxt_psnr's argument is.
+typedef struct
+{
+    int print_out;
+    int print_embl;
+    int run_ssim;
+    int potential_artifact;
+    double psnr;
+    double ssim;
+    void *state;
+} VPXT_ENCODE_PSNR;
+
+void vpxt_encode_psnr_init(VPXT_ENCODE_PSNR *psnr, int print_out,
+                           int run_ssim, int potential_artifact);
 int vpxt_compress(const char *inputFile,
                   const char *outputFile2,
                   int speed,
@@ -229,6 +301,17 @@ int vpxt_compress(const char *inputFile,
                   int RunQCheck,
                   std::string EncFormat,
                   int set_config);
+int vpxt_compress(const char *inputFile,
+                  const char *outputFile2,
+                  int speed,
+                  int BitRate,
+                  VP8_CONFIG &oxcf,
+                  const char *CompressString,
+                  int CompressInt,
+                  int RunQCheck,
+                  std::string EncFormat,
+                  int set_config,
+                  VPXT_ENCODE_PSNR *psnr);
 int vpxt_compress_no_error_output(const char *inputFile,
                                   const char *outputFile2,
                                   int speed,
@@ -238,16 +321,44 @@ int vpxt_compress_no_error_output(const char *inputFile,
                                   int CompressInt,
                                   int RunQCheck,
                                   std::string EncFormat);
-unsigned int vpxt_time_compress(const char *inputFile,
-                                const char *outputFile2,
-                                int speed,
-                                int BitRate,
-                                VP8_CONFIG &oxcf,
-                                const char *CompressString,
-                                int CompressInt,
-                                int RunQCheck,
-                                unsigned int &CPUTick,
-                                std::string EncFormat);
+uint64_t vpxt_time_compress(const char *inputFile,
+                            const char *outputFile2,
+                            int speed,
+                            int BitRate,
+                            VP8_CONFIG &oxcf,
+                            const char *CompressString,
+                            int CompressInt,
+                            int RunQCheck,
+                            uint64_t &CPUTick,
+                            std::string EncFormat);
+uint64_t vpxt_time_compress(const char *inputFile,
+                            const char *outputFile2,
+                            int speed,
+                            int BitRate,
+                            VP8_CONFIG &oxcf,
+                            const char *CompressString,
+                            int CompressInt,
+                            int RunQCheck,
+                            uint64_t &CPUTick,
+                            std::string EncFormat,
+                            VPXT_ENCODE_PSNR *psnr);
+// vpxt_time_compress repeated as config asks with one metric sample kept
+// per run.  psnr is only measured on the last run.  Samples are written to
+// a compression_bench.txt sidecar for vpxt_bench_return.  Returns -1 if an
+// encode failed.
+int vpxt_bench_time_compress(const VPXT_BENCH_CONFIG *config,
+                             int metric,
+                             const char *inputFile,
+                             const char *outputFile2,
+                             int speed,
+                             int BitRate,
+                             VP8_CONFIG &oxcf,
+                             const char *CompressString,
+                             int CompressInt,
+                             int RunQCheck,
+                             std::string EncFormat,
+                             VPXT_ENCODE_PSNR *psnr,
+                             VPXT_BENCH_RESULT *result);
 int vpxt_compress_force_key_frame(const char *inputFile,
                                   const char *outputFile2,
                                   int speed,
@@ -325,16 +436,56 @@ int vpxt_decompress_no_output(const char *inputchar,
                               const char *outputchar,
                               std::string DecFormat,
                               int threads);
-unsigned int vpxt_time_decompress(const char *inputchar,
-                                  const char *outputchar,
-                                  unsigned int &CPUTick,
-                                  std::string DecFormat,
-                                  int threads);
-unsigned int vpxt_decompress_time_and_output(const char *inputchar,
-                                             const char *outputchar,
-                                             unsigned int &CPUTick,
-                                             std::string DecFormat,
-                                             int threads);
+uint64_t vpxt_time_decompress(const char *inputchar,
+                              const char *outputchar,
+                              uint64_t &CPUTick,
+                              std::string DecFormat,
+                              int threads);
+uint64_t vpxt_decompress_time_and_output(const char *inputchar,
+                                         const char *outputchar,
+                                         uint64_t &CPUTick,
+                                         std::string DecFormat,
+                                         int threads);
+// vpxt_decompress_time_and_output repeated as config asks, samples go to a
+// decompression_bench.txt sidecar.  Pinning covers threads processors.
+int vpxt_bench_time_decompress(const VPXT_BENCH_CONFIG *config,
+                               int metric,
+                               const char *inputchar,
+                               const char *outputchar,
+                               std::string DecFormat,
+                               int threads,
+                               VPXT_BENCH_RESULT *result);
+// Decoder throughput of one compressed file.  Frames are read into memory
+// first and decoded with the output discarded, so only the decoder is
+// timed.  time holds the decode time of every run in microseconds, the
+// latency percentiles cover every frame of every timed run.
+typedef struct
+{
+    int frames;
+    unsigned int width;
+    unsigned int height;
+    double bytes;
+    VPXT_BENCH_RESULT time;
+    unsigned int latency_p50;
+    unsigned int latency_p90;
+    unsigned int latency_p99;
+    unsigned int latency_max;
+} VPXT_DEC_BENCH;
+
+// postproc is the deblocking level, 0 decodes without post processing.
+// Returns -1 if the file could not be read or decoded.
+int vpxt_dec_bench(const VPXT_BENCH_CONFIG *config,
+                   const char *inputchar,
+                   int threads,
+                   int postproc,
+                   VPXT_DEC_BENCH *result);
+// md5 gets the MD5 of the decoded frames' planes as hex, computed while
+// decoding without writing them out.  A frame that fails to decode ends the
+// MD5 at the frame before it, so the file fails on its MD5.
+int vpxt_dec_md5(const char *inputchar, int threads, char md5[33]);
+// Returns 0 if every frame decodes, -2 if one fails and -1 if the file
+// could not be read.
+int vpxt_dec_check(const char *inputchar, int threads);
 int vpxt_dec_compute_md5(const char *inputchar, const char *outputchar);
 #endif
 //------------------------------IVF Tools---------------------------------------
@@ -391,8 +542,21 @@ int vpxt_eval_frame_stats_temp_scale(const char *input_file, int pattern);
 int vpxt_check_min_quantizer(const char *inputFile, int MinQuantizer);
 int vpxt_check_max_quantizer(const char *inputFile, int MaxQuantizer);
 int vpxt_check_fixed_quantizer(const char *inputFile, int FixedQuantizer);
-int vpxt_time_return(const char *infile, int FileType);
-int vpxt_cpu_tick_return(const char *infile, int FileType);
+uint64_t vpxt_time_return(const char *infile, int FileType);
+uint64_t vpxt_cpu_tick_return(const char *infile, int FileType);
+int vpxt_latency_return(const char *infile,
+                        int FileType,
+                        int FrameType,
+                        int Percentile);
+int vpxt_bench_return(const char *infile,
+                      int FileType,
+                      int metric,
+                      const VPXT_BENCH_CONFIG *config,
+                      VPXT_BENCH_RESULT *result);
+void vpxt_bench_print(const char *label,
+                      int metric,
+                      const VPXT_BENCH_CONFIG *config,
+                      const VPXT_BENCH_RESULT *result);
 int vpxt_check_force_key_frames(const char *KeyFrameoutputfile,
                                 int ForceKeyFrameInt,
                                 const char *ForceKeyFrame);
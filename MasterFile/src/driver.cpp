@@ -208,6 +208,10 @@ void vpxt_on_error_output()
         "Help\n");
     tprintf(PRINT_STD, "  (48) test_win_lin_mac_match               "
         "\n");
+    tprintf(PRINT_STD, "  (49) test_dec_bench_json                  "
+        "\n");
+    tprintf(PRINT_STD, "  (50) test_two_pass_webm                   "
+        "\n");
 #if !defined(_WIN32)
     tprintf(PRINT_STD, "\n");
 #endif
@@ -232,6 +236,9 @@ int show_hidden_cmds()
         "Quad\n"
         "CompareDec\n"
         "PrintCpuInfo\n"
+        "PsnrKernelBench\n"
+        "DecBench\n"
+        "ParetoSweep\n"
         "\n"
         "CopyAllTxtFiles\n"
         "\n"
@@ -306,6 +313,9 @@ void write_32bit_quick_test(const std::string& working_dir)
         "test_test_vector", 2, slashChar(), slashChar());
     fprintf(fp, "%s@..%cTestClips%csrc16.ivf@128@webm@y4m\n",
         "test_two_pass_vs_two_pass_best", slashChar(), slashChar());
+    fprintf(fp, "%s\n", "test_dec_bench_json");
+    fprintf(fp, "%s@..%cTestClips%csrc16.ivf@128\n",
+        "test_two_pass_webm", slashChar(), slashChar());
     fprintf(fp, "%%%s@..%cTestClips%csrc16.ivf@1@128@0@NA@NA@NA@webm@y4m\n",
         "test_win_lin_mac_match", slashChar(), slashChar());
     fprintf(fp, "%s@..%cTestClips%cBBB_720x480_2000F.ivf@0@400@600@0@0@0@webm"
@@ -837,6 +847,9 @@ void write_64bit_quick_test(const std::string& working_dir)
         "test_test_vector", 2, slashChar(), slashChar());
     fprintf(fp, "%s@..%cTestClips%csrc16.ivf@128@webm@y4m\n",
         "test_two_pass_vs_two_pass_best", slashChar(), slashChar());
+    fprintf(fp, "%s\n", "test_dec_bench_json");
+    fprintf(fp, "%s@..%cTestClips%csrc16.ivf@128\n",
+        "test_two_pass_webm", slashChar(), slashChar());
     fprintf(fp, "%%%i@..%cTestClips%csrc16.ivf@1@128@0@NA@NA@NA\n",
         "test_win_lin_mac_match", slashChar(), slashChar());
     fprintf(fp, "%s@..%cTestClips%cBBB_720x480_2000F.ivf@0@400@600@0@0@0@webm"
@@ -2571,6 +2584,45 @@ int vpxt_test_help(const char *input_char, int printSummary)
             "the files are identical, the test passes.");
     }
 
+    if (selector == kTestDecBenchJson)
+    {
+        if (printSummary)
+            tprintf(PRINT_STD, "\nUse:\n\n%2i", selector);
+        else
+            tprintf(PRINT_STD, " ");
+
+        vpxt_cap_string_print(PRINT_STD, " %s\n", input_str.c_str());
+
+        tprintf(PRINT_STD, "\n");
+
+        if (printSummary)
+            vpxt_formated_print(HLPPRT, "The test writes file names with "
+            "quotes, backslashes, control characters and JSON syntax in "
+            "them to a decbench style JSON file and reads them back the "
+            "way decbench reads a baseline. If every file name reads back "
+            "unchanged, the test passes.");
+    }
+
+    if (selector == kTestTwoPassWebm)
+    {
+        if (printSummary)
+            tprintf(PRINT_STD, "\nUse:\n\n%2i", selector);
+        else
+            tprintf(PRINT_STD, " ");
+
+        vpxt_cap_string_print(PRINT_STD, " %s\n", input_str.c_str());
+
+        tprintf(PRINT_STD, "\n"
+            "    <Input File>\n"
+            "    <Target Bit Rate>\n"
+            "     <Optional Settings File>\n");
+
+        if (printSummary)
+            vpxt_formated_print(HLPPRT, "The test creates a two-pass good "
+            "quality WebM compression for the input target bandwidth and "
+            "decodes it. If every frame decodes, the test passes.");
+    }
+
 #if !defined(_WIN32)
 
     if (!printSummary)
@@ -3647,6 +3699,12 @@ void format_summary(const char *ptr_input_file_name)
         if (test_track == kTestWinLinMacMatch)
             test_track_name = "Test_Win_Lin_Mac_Match";
 
+        if (test_track == kTestDecBenchJson)
+            test_track_name = "Test_Dec_Bench_Json";
+
+        if (test_track == kTestTwoPassWebm)
+            test_track_name = "Test_Two_Pass_Webm";
+
         int track_passed = 0;
         int track_failed = 0;
         int track_indter = 0;
@@ -4384,6 +4442,20 @@ int main(int argc, const char** argv)
     if (input_1_str.compare("printcpuinfo") == 0)
         return tool_print_cpu_info();
 
+    // times the psnr sum of squared error kernels on 1080p planes
+    if (input_1_str.compare("psnrkernelbench") == 0)
+        return tool_psnr_kernel_bench(argc, argv);
+
+    // decoder throughput of files decoded from memory, optionally against
+    // a baseline
+    if (input_1_str.compare("decbench") == 0)
+        return tool_dec_bench(argc, argv);
+
+    // encodes a clip over every combination of mode, cpu_used, threads and
+    // token partitions to find the speed and quality pareto frontier
+    if (input_1_str.compare("paretosweep") == 0)
+        return tool_pareto_sweep(argc, argv);
+
     // Copies all text files in a directory to a new directory preserving file
     // structure
     if (input_1_str.compare("copyalltxtfiles") == 0)
@@ -4609,6 +4681,14 @@ int main(int argc, const char** argv)
         return test_win_lin_mac_match(argc, argv, working_dir, sub_folder_str,
         1, KEEP_IVF, NO_ART_DET);
 
+    if (selector == kTestDecBenchJson)
+        return test_dec_bench_json(argc, argv, working_dir, sub_folder_str,
+        1, KEEP_IVF, NO_ART_DET);
+
+    if (selector == kTestTwoPassWebm)
+        return test_two_pass_webm(argc, argv, working_dir, sub_folder_str,
+        1, KEEP_IVF, NO_ART_DET);
+
     vpxt_on_error_output();
     return 0;
 }
\ No newline at end of file
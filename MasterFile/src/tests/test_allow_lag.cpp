@@ -1,4 +1,5 @@
 #include "vpxt_test_declarations.h"
+#include "vpxt_frame_scan.h"
 
 int test_allow_lag(int argc,
                    const char** argv,
@@ -107,14 +108,21 @@ int test_allow_lag(int argc,
     quant_in_str += "quantizers.txt";
 
     int lag_in_frames_found = vpxt_lag_in_frames_check(quant_in_str.c_str());
-    int allow_lag_on_alt_ref_count = vpxt_display_alt_ref_frames(
-        allow_lag_on_enc.c_str(), 1);
-    int allow_lag_off_alt_ref_count = vpxt_display_alt_ref_frames(
-        allow_lag_off_enc.c_str() , 1);
-    int visible_frame_on_count = vpxt_display_visible_frames(
-        allow_lag_on_enc.c_str(), 1);
-    int visible_frame_off_count = vpxt_display_visible_frames(
-        allow_lag_off_enc.c_str(), 1);
+
+    VPXT_FRAME_SCAN scan_on;
+    vpxt_frame_scan_init(&scan_on, VPXT_SCAN_ALT_REF | VPXT_SCAN_VISIBLE);
+    vpxt_frame_scan(allow_lag_on_enc.c_str(), &scan_on);
+    vpxt_frame_scan_write(allow_lag_on_enc.c_str(), &scan_on);
+
+    VPXT_FRAME_SCAN scan_off;
+    vpxt_frame_scan_init(&scan_off, VPXT_SCAN_ALT_REF | VPXT_SCAN_VISIBLE);
+    vpxt_frame_scan(allow_lag_off_enc.c_str(), &scan_off);
+    vpxt_frame_scan_write(allow_lag_off_enc.c_str(), &scan_off);
+
+    int allow_lag_on_alt_ref_count = scan_on.alt_ref_frames.size();
+    int allow_lag_off_alt_ref_count = scan_off.alt_ref_frames.size();
+    int visible_frame_on_count = scan_on.visible_frames.size();
+    int visible_frame_off_count = scan_off.visible_frames.size();
 
     char allow_lag_on_file_name[255];
     vpxt_file_name(allow_lag_on_enc.c_str(), allow_lag_on_file_name, 0);
@@ -92,7 +92,7 @@ int test_arnr(int argc,
 
         opt.play_alternate = 0;
         opt.arnr_type = 1;
-        unsigned int cpu_tick_0 = 0;
+        uint64_t cpu_tick_0 = 0;
 
         time_0 = vpxt_time_compress(input.c_str(), arnr_0_enc.c_str(),
             speed, bitrate, opt, "Play Alternate", opt.arnr_type, 0, cpu_tick_0,
@@ -108,7 +108,7 @@ int test_arnr(int argc,
 
         opt.play_alternate = 1;
         opt.arnr_type = 1;
-        unsigned int cpu_tick_1 = 0;
+        uint64_t cpu_tick_1 = 0;
 
         time_1 = vpxt_time_compress(input.c_str(), arnr_1_enc.c_str(), speed,
             bitrate, opt, comp_out_str, opt.arnr_type, 0, cpu_tick_1,
@@ -123,7 +123,7 @@ int test_arnr(int argc,
         }
 
         opt.arnr_type = 2;
-        unsigned int cpu_tick_2 = 0;
+        uint64_t cpu_tick_2 = 0;
 
         time_2 = vpxt_time_compress(input.c_str(), arnr_2_enc.c_str(), speed,
             bitrate, opt, comp_out_str, opt.arnr_type, 0, cpu_tick_2,
@@ -138,7 +138,7 @@ int test_arnr(int argc,
         }
 
         opt.arnr_type = 3;
-        unsigned int cpu_tick3 = 0;
+        uint64_t cpu_tick3 = 0;
 
         time_3 = vpxt_time_compress(input.c_str(), arnr_3_enc.c_str(), speed,
             bitrate, opt, comp_out_str, opt.arnr_type, 0, cpu_tick3,enc_format);
@@ -207,7 +207,7 @@ int test_change_cpu_dec(int argc,
         vpxt_dec_format_append(output_2_str, dec_format);
 
         tprintf(PRINT_BTH, "\n\nDetected CPU capability: none");
-        unsigned int cpu_tick_1 = 0;
+        uint64_t cpu_tick_1 = 0;
         total_ms = vpxt_decompress_time_and_output(cpu_dec_only_enc.c_str()
             , output_2_str.c_str(), cpu_tick_1, dec_format, 1);
         decompression_vector.push_back(output_2_str);
@@ -296,7 +296,7 @@ int test_change_cpu_dec(int argc,
                 change_cpu_dec_out_file_1 += cpu_str.c_str();
                 vpxt_dec_format_append(change_cpu_dec_out_file_1, dec_format);
 
-                unsigned int cpu_tick_2 = 0;
+                uint64_t cpu_tick_2 = 0;
                 total_ms_2 =
                  vpxt_decompress_time_and_output(cpu_dec_only_enc.c_str(),
                  change_cpu_dec_out_file_1.c_str(), cpu_tick_2, dec_format, 1);
@@ -76,7 +76,7 @@ int test_constrained_quality(int argc,
     {
         opt.Mode = mode;
         opt.end_usage = 1;
-        unsigned int cpu_tick1_conq_off = 0;
+        uint64_t cpu_tick1_conq_off = 0;
 
         time_1 = vpxt_time_compress(input.c_str(), constrained_q_off_enc.c_str()
             , speed, bitrate, opt, comp_out_str, 0, 1, cpu_tick1_conq_off,
@@ -92,7 +92,7 @@ int test_constrained_quality(int argc,
 
         opt.end_usage = 2;
         opt.cq_level = constrained_q;
-        unsigned int cpu_tick1_conq_on = 0;
+        uint64_t cpu_tick1_conq_on = 0;
 
         time_2 = vpxt_time_compress(input.c_str(), constrained_q_on_enc.c_str(),
             speed, bitrate, opt, comp_out_str, 1, 1, cpu_tick1_conq_on,
@@ -0,0 +1,161 @@
+#include "vpxt_test_declarations.h"
+#include "vpxt_json.h"
+
+// File names the decoder benchmark has to key its baseline on, each with
+// characters JSON has to escape or that look like JSON syntax.
+static const char *dec_bench_json_names[] =
+{
+    "src16.ivf",
+    "quote \"name\".ivf",
+    "back\\slash.ivf",
+    "..\\TestClips\\src16.ivf",
+    "tab\tand\nnewline\r.ivf",
+    "control \x01\x1f.ivf",
+    "comma, colon: {brace} [bracket].ivf",
+    "\", \"fps\": 0, \"file\": \".ivf",
+    "trailing backslash\\",
+    "caf\xc3\xa9.ivf"
+};
+
+#define dec_bench_json_name_count \
+    (int)(sizeof(dec_bench_json_names) / sizeof(dec_bench_json_names[0]))
+
+int test_dec_bench_json(int argc,
+                        const char** argv,
+                        const std::string &working_dir,
+                        const std::string sub_folder_str,
+                        int test_type,
+                        int delete_ivf,
+                        int artifact_detection)
+{
+    char *test_dir = "test_dec_bench_json";
+    int input_ver = vpxt_check_arg_input(argv[1], argc);
+
+    if (input_ver < 0)
+        return vpxt_test_help(argv[1], 0);
+
+    //////////// Formatting Test Specific directory ////////////
+    std::string cur_test_dir_str;
+    std::string file_index_str;
+    char main_test_dir_char[255] = "";
+    char file_index_output_char[255] = "";
+
+    if (initialize_test_directory(argc, argv, test_type, working_dir, test_dir,
+        cur_test_dir_str, file_index_str, main_test_dir_char,
+        file_index_output_char, sub_folder_str) == 11)
+        return kTestErrFileMismatch;
+
+    std::string json_str = cur_test_dir_str + slashCharStr() + test_dir +
+        "_baseline.json";
+
+    ///////////// Open Output File and Print Header ////////////
+    std::string text_file_str = cur_test_dir_str + slashCharStr() + test_dir;
+    FILE *fp;
+
+    vpxt_open_output_file(test_type, text_file_str, fp);
+    vpxt_print_header(argc, argv, main_test_dir_char, cur_test_dir_str,
+        test_dir, test_type);
+
+    // nothing is encoded, a compression only run stops here
+    if (test_type == kCompOnly)
+    {
+        fclose(fp);
+        record_test_complete(file_index_str, file_index_output_char, test_type);
+        return kTestEncCreated;
+    }
+
+    // write the names the way decbench writes its output, then read them
+    // back the way it reads a baseline
+    FILE *json = fopen(json_str.c_str(), "wb");
+
+    if (!json)
+    {
+        tprintf(PRINT_BTH, "\nCould not open %s\n", json_str.c_str());
+        fclose(fp);
+        record_test_complete(file_index_str, file_index_output_char, test_type);
+        return kTestIndeterminate;
+    }
+
+    fprintf(json, "[\n");
+
+    int i;
+
+    for (i = 0; i < dec_bench_json_name_count; i++)
+    {
+        std::string json_file;
+        vpxt_json_string(json_file, dec_bench_json_names[i]);
+
+        fprintf(json, "%s{\"file\": %s, \"threads\": %i, \"postproc\": %i, "
+            "\"fps\": %.2f, \"status\": \"New\"}", i ? ",\n" : "",
+            json_file.c_str(), i, 0, 30.0 + i);
+    }
+
+    fprintf(json, "\n]\n");
+    fclose(json);
+
+    std::ifstream baseline(json_str.c_str(), std::ios::binary);
+    std::string line;
+    std::vector<std::string> read_names;
+
+    while (std::getline(baseline, line))
+    {
+        std::vector<std::string> names;
+        std::vector<std::string> values;
+
+        if (vpxt_json_parse_record(line, names, values))
+            continue;
+
+        const std::string *file = vpxt_json_field(names, values, "file");
+        const std::string *fps = vpxt_json_field(names, values, "fps");
+
+        if (file && fps)
+            read_names.push_back(*file);
+    }
+
+    baseline.close();
+
+    int test_state = kTestPassed;
+
+    tprintf(PRINT_BTH, "\n\nResults:\n\n");
+
+    for (i = 0; i < dec_bench_json_name_count; i++)
+    {
+        std::string json_file;
+        vpxt_json_string(json_file, dec_bench_json_names[i]);
+
+        if (i < (int)read_names.size() &&
+            read_names[i].compare(dec_bench_json_names[i]) == 0)
+        {
+            vpxt_formated_print(RESPRT, "File name %s reads back from the "
+                "baseline unchanged - Passed", json_file.c_str());
+            tprintf(PRINT_BTH, "\n");
+        }
+        else
+        {
+            vpxt_formated_print(RESPRT, "File name %s does not read back from "
+                "the baseline unchanged - Failed", json_file.c_str());
+            tprintf(PRINT_BTH, "\n");
+            test_state = kTestFailed;
+        }
+    }
+
+    if (read_names.size() != (size_t)dec_bench_json_name_count)
+    {
+        vpxt_formated_print(RESPRT, "%i records written, %i read back - "
+            "Failed", dec_bench_json_name_count, (int)read_names.size());
+        tprintf(PRINT_BTH, "\n");
+        test_state = kTestFailed;
+    }
+
+    if (test_state == kTestFailed)
+        tprintf(PRINT_BTH, "\nFailed\n");
+    if (test_state == kTestPassed)
+        tprintf(PRINT_BTH, "\nPassed\n");
+
+    if (delete_ivf)
+        vpxt_delete_files(1, json_str.c_str());
+
+    fclose(fp);
+    record_test_complete(file_index_str, file_index_output_char, test_type);
+    return test_state;
+}
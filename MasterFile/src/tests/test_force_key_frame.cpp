@@ -1,4 +1,5 @@
 #include "vpxt_test_declarations.h"
+#include "vpxt_frame_scan.h"
 
 int test_force_key_frame(int argc,
                          const char** argv,
@@ -90,10 +91,17 @@ int test_force_key_frame(int argc,
         return kTestEncCreated;
     }
 
-    vpxt_display_key_frames(ForceKeyFrame.c_str(), 1);
+    VPXT_FRAME_SCAN scan;
+    vpxt_frame_scan_init(&scan, VPXT_SCAN_KEY_FRAMES);
 
-    int f_key_frames = vpxt_check_force_key_frames(KeyFrameoutputfile.c_str(),
-        ForceKeyFrameInt, ForceKeyFrame.c_str());
+    int f_key_frames = vpxt_frame_scan(ForceKeyFrame.c_str(), &scan);
+
+    if (f_key_frames == 0)
+    {
+        vpxt_frame_scan_write(ForceKeyFrame.c_str(), &scan);
+        f_key_frames = vpxt_frame_scan_force_key_check(&scan,
+            ForceKeyFrameInt);
+    }
 
     int test_state = kTestFailed;
 
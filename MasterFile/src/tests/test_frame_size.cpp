@@ -1,4 +1,83 @@
 #include "vpxt_test_declarations.h"
+#include "vpxt_sweep.h"
+
+// One crop, encode and psnr of the 46 frame sizes per sweep job.
+struct frame_size_sweep
+{
+    const char *input;
+    const char *comp_out_str;
+    const char *enc_format;
+    int starting_width;
+    int starting_height;
+    int speed;
+    int bitrate;
+    int delete_ivf;
+    VP8_CONFIG opt;
+    std::string *raw_crop;
+    std::string *enc_crop;
+    int *enc_crop_art_det;
+    double *psnr_arr;
+};
+
+static int frame_size_sweep_job(void *arg, int job)
+{
+    frame_size_sweep *sweep = (frame_size_sweep *)arg;
+    int raw_crop_num = job + 1;
+    int width = sweep->starting_width;
+    int height = sweep->starting_height;
+
+    // height, then width, then width and height
+    if (job < 16)
+        height -= job;
+    else if (job < 31)
+        width -= job - 15;
+    else
+    {
+        width -= job - 30;
+        height -= job - 30;
+    }
+
+    const char *raw = sweep->raw_crop[raw_crop_num].c_str();
+    const char *enc = sweep->enc_crop[raw_crop_num].c_str();
+
+    // Crop
+    tprintf(PRINT_BTH, "\nCroping to %i %i", width, height);
+    vpxt_crop_raw_clip(sweep->input, raw, 0, 0, width, height, 1, 1);
+
+    // Comp
+    char file_name_char[256];
+    vpxt_file_name(raw, file_name_char, 1);
+
+    tprintf(PRINT_BTH, "\n\nCompressing %s", file_name_char);
+
+    VP8_CONFIG opt = sweep->opt;
+
+    if (vpxt_compress(raw, enc, sweep->speed, sweep->bitrate, opt,
+        sweep->comp_out_str, 0, 0, sweep->enc_format, kSetConfigOff) == -1)
+        return -1;
+
+    // PSNR
+    sweep->psnr_arr[job] = vpxt_psnr(raw, enc, 0, PRINT_BTH, 1, 0, 0, 0, NULL,
+        sweep->enc_crop_art_det[raw_crop_num]);
+
+    std::string psnr_out_file;
+    vpxt_remove_file_extension(enc, psnr_out_file);
+    psnr_out_file += "psnr.txt";
+
+    std::ofstream out_file_psnr(psnr_out_file.c_str());
+    out_file_psnr << sweep->psnr_arr[job];
+    out_file_psnr.close();
+
+    // Delete(file deletions are done here due to the number of files that
+    // need to be generated)
+    if (sweep->delete_ivf)
+    {
+        vpxt_delete_files(1, raw);
+        vpxt_delete_files(1, enc);
+    }
+
+    return 0;
+}
 
 int test_frame_size(int argc,
                     const char** argv,
@@ -188,166 +267,40 @@ int test_frame_size(int argc,
     }
     else
     {
-        // Create Raw Crops
-        int x = 0;
+        // Create Raw Crops, every frame size is encoded side by side
         opt.Mode = mode;
 
-        while (x < 16)
+        frame_size_sweep sweep_arg;
+        sweep_arg.input = input.c_str();
+        sweep_arg.comp_out_str = comp_out_str;
+        sweep_arg.enc_format = enc_format.c_str();
+        sweep_arg.starting_width = starting_width;
+        sweep_arg.starting_height = starting_height;
+        sweep_arg.speed = speed;
+        sweep_arg.bitrate = bitrate;
+        sweep_arg.delete_ivf = delete_ivf;
+        sweep_arg.opt = opt;
+        sweep_arg.raw_crop = raw_crop;
+        sweep_arg.enc_crop = enc_crop;
+        sweep_arg.enc_crop_art_det = enc_crop_art_det;
+        sweep_arg.psnr_arr = psnr_arr;
+
+        int sweep_results[46];
+        VPXT_SWEEP sweep;
+        vpxt_sweep_init(&sweep, 0);
+        vpxt_sweep_run(&sweep, frame_size_sweep_job, &sweep_arg, 46,
+            sweep_results);
+        vpxt_sweep_destroy(&sweep);
+
+        for (raw_crop_num = 0; raw_crop_num < 46; raw_crop_num++)
         {
-            // Crop
-            tprintf(PRINT_BTH, "\nCroping to %i %i", starting_width,
-                starting_height - x);
-            vpxt_crop_raw_clip(input.c_str(), raw_crop[raw_crop_num].c_str(), 0,
-                0, starting_width, starting_height - x, 1, 1);
-
-            // Comp
-            char file_name_char[256];
-            char file_name_char_2[256];
-            snprintf(file_name_char, 256, raw_crop[raw_crop_num].c_str());
-            vpxt_file_name(file_name_char, file_name_char_2, 1);
-
-            tprintf(PRINT_BTH, "\n\nCompressing %s", file_name_char_2);
-
-            if (vpxt_compress(raw_crop[raw_crop_num].c_str(),
-                enc_crop[raw_crop_num].c_str(), speed, bitrate, opt,
-                comp_out_str, 0, 0, enc_format, kSetConfigOff) == -1)
+            if (sweep_results[raw_crop_num] == -1)
             {
                 fclose(fp);
                 record_test_complete(file_index_str, file_index_output_char,
                     test_type);
                 return kTestIndeterminate;
             }
-
-            // PSNR
-            psnr_arr[raw_crop_num-1] = vpxt_psnr(raw_crop[raw_crop_num].c_str(),
-                enc_crop[raw_crop_num].c_str(), 0, PRINT_BTH, 1, 0, 0, 0, NULL,
-                enc_crop_art_det[raw_crop_num]);
-
-            std::string psnr_out_file;
-            vpxt_remove_file_extension(enc_crop[raw_crop_num].c_str(),
-                psnr_out_file);
-            psnr_out_file += "psnr.txt";
-
-            std::ofstream out_file_psnr(psnr_out_file.c_str());
-            out_file_psnr << psnr_arr[raw_crop_num-1];
-            out_file_psnr.close();
-
-            // Delete(file deletions are done here due to the number of files
-            // that need to be generated)
-            if (delete_ivf)
-            {
-                vpxt_delete_files(1, raw_crop[raw_crop_num].c_str());
-                vpxt_delete_files(1, enc_crop[raw_crop_num].c_str());
-            }
-
-            ++x;
-            ++raw_crop_num;
-        }
-
-        x = 1;
-
-        while (x < 16)
-        {
-            // Crop
-            tprintf(PRINT_BTH, "\nCroping to %i %i", starting_width - x,
-                starting_height);
-            vpxt_crop_raw_clip(input.c_str(), raw_crop[raw_crop_num].c_str(), 0,
-                0, starting_width - x, starting_height, 1, 1);
-
-            // Comp
-            char file_name_char[256];
-            char file_name_char_2[256];
-            snprintf(file_name_char, 256, enc_crop[raw_crop_num].c_str());
-            vpxt_file_name(file_name_char, file_name_char_2, 1);
-
-            tprintf(PRINT_BTH, "\nCompressing %s", file_name_char_2);
-
-            if (vpxt_compress(raw_crop[raw_crop_num].c_str(),
-                enc_crop[raw_crop_num].c_str(), speed, bitrate, opt,
-                comp_out_str, 0, 0, enc_format, kSetConfigOff) == -1)
-            {
-                fclose(fp);
-                record_test_complete(file_index_str, file_index_output_char,
-                    test_type);
-                return kTestIndeterminate;
-            }
-
-            // PSNR
-            psnr_arr[raw_crop_num-1] = vpxt_psnr(raw_crop[raw_crop_num].c_str(),
-                enc_crop[raw_crop_num].c_str(), 0, PRINT_BTH, 1, 0, 0, 0, NULL,
-                enc_crop_art_det[raw_crop_num]);
-
-            std::string psnr_out_file;
-            vpxt_remove_file_extension(enc_crop[raw_crop_num].c_str(),
-                psnr_out_file);
-            psnr_out_file += "psnr.txt";
-
-            std::ofstream out_file_psnr(psnr_out_file.c_str());
-            out_file_psnr << psnr_arr[raw_crop_num-1];
-            out_file_psnr.close();
-
-            // Delete
-            if (delete_ivf)
-            {
-                vpxt_delete_files(1, raw_crop[raw_crop_num].c_str());
-                vpxt_delete_files(1, enc_crop[raw_crop_num].c_str());
-            }
-
-            ++x;
-            ++raw_crop_num;
-        }
-
-        x = 1;
-
-        while (x < 16)
-        {
-            // Crop
-            tprintf(PRINT_BTH, "\nCroping to %i %i", starting_width - x,
-                starting_height - x);
-            vpxt_crop_raw_clip(input.c_str(), raw_crop[raw_crop_num].c_str(), 0,
-                0, starting_width - x, starting_height - x, 1, 1);
-
-            // Comp
-            char file_name_char[256];
-            char file_name_char_2[256];
-            snprintf(file_name_char, 256, raw_crop[raw_crop_num].c_str());
-            vpxt_file_name(file_name_char, file_name_char_2, 1);
-
-            tprintf(PRINT_BTH, "\nCompressing %s", file_name_char_2);
-
-            if (vpxt_compress(raw_crop[raw_crop_num].c_str(),
-                enc_crop[raw_crop_num].c_str(), speed, bitrate, opt,
-                comp_out_str, 0, 0, enc_format, kSetConfigOff) == -1)
-            {
-                fclose(fp);
-                record_test_complete(file_index_str, file_index_output_char,
-                    test_type);
-                return kTestIndeterminate;
-            }
-
-            // PSNR
-            psnr_arr[raw_crop_num-1] = vpxt_psnr(raw_crop[raw_crop_num].c_str(),
-                enc_crop[raw_crop_num].c_str(), 0, PRINT_BTH, 1, 0, 0, 0, NULL,
-                enc_crop_art_det[raw_crop_num]);
-
-            std::string psnr_out_file;
-            vpxt_remove_file_extension(enc_crop[raw_crop_num].c_str(),
-                psnr_out_file);
-            psnr_out_file += "psnr.txt";
-
-            std::ofstream out_file_psnr(psnr_out_file.c_str());
-            out_file_psnr << psnr_arr[raw_crop_num-1];
-            out_file_psnr.close();
-
-            // Delete
-            if (delete_ivf)
-            {
-                vpxt_delete_files(1, raw_crop[raw_crop_num].c_str());
-                vpxt_delete_files(1, enc_crop[raw_crop_num].c_str());
-            }
-
-            ++x;
-            ++raw_crop_num;
         }
     }
 
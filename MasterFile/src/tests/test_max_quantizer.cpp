@@ -1,4 +1,70 @@
 #include "vpxt_test_declarations.h"
+#include "vpxt_sweep.h"
+
+// One encode of the quantizer ladder per sweep job.
+struct max_q_sweep
+{
+    const char *input;
+    const char *comp_out_str;
+    const char *enc_format;
+    int test_type;
+    int mode;
+    int speed;
+    int bitrate;
+    VP8_CONFIG opt;
+    std::string *quant_out_enc_arr;
+    int *quant_arr;
+    int *art_det_arr;
+    double *psnr_arr;
+    int *max_q_verify_arr;
+};
+
+static int max_q_sweep_job(void *arg, int file_num)
+{
+    max_q_sweep *sweep = (max_q_sweep *)arg;
+    const char *output = sweep->quant_out_enc_arr[file_num].c_str();
+
+    if (sweep->test_type == kTestOnly)
+    {
+        sweep->psnr_arr[file_num] = vpxt_psnr(sweep->input, output, 0,
+            PRINT_BTH, 1, 0, 0, 0, NULL, sweep->art_det_arr[file_num]);
+        tprintf(PRINT_BTH, "\n");
+
+        sweep->max_q_verify_arr[file_num] = vpxt_check_max_quantizer(output,
+            sweep->quant_arr[file_num]);
+        tprintf(PRINT_BTH, "\n");
+        return 0;
+    }
+
+    VP8_CONFIG opt = sweep->opt;
+    opt.worst_allowed_q = sweep->quant_arr[file_num];
+    opt.Mode = sweep->mode;
+
+    // psnr is measured while encoding
+    VPXT_ENCODE_PSNR enc_psnr;
+    vpxt_encode_psnr_init(&enc_psnr, PRINT_BTH, 0,
+        sweep->art_det_arr[file_num]);
+
+    if (vpxt_compress(sweep->input, output, sweep->speed, sweep->bitrate, opt,
+        sweep->comp_out_str, sweep->quant_arr[file_num], 1, sweep->enc_format,
+        kSetConfigOff, sweep->test_type != kCompOnly ? &enc_psnr : NULL) == -1)
+        return -1;
+
+    tprintf(PRINT_BTH, "\n");
+
+    if (sweep->test_type != kCompOnly)
+    {
+        sweep->psnr_arr[file_num] = enc_psnr.psnr;
+        sweep->art_det_arr[file_num] = enc_psnr.potential_artifact;
+        tprintf(PRINT_BTH, "\n");
+
+        sweep->max_q_verify_arr[file_num] = vpxt_check_max_quantizer(output,
+            sweep->quant_arr[file_num]);
+        tprintf(PRINT_BTH, "\n");
+    }
+
+    return 0;
+}
 
 int test_max_quantizer(int argc,
                        const char** argv,
@@ -84,62 +150,41 @@ int test_max_quantizer(int argc,
     double psnr_arr[10];
     int max_q_verify_arr[10];
 
-    // Run Test only (Runs Test, Sets up test to be run, or skips compresion of
-    // files)
-    if (test_type == kTestOnly)
-    {
-        file_num = 0;
-        while (file_num < 8)
-        {
-                psnr_arr[file_num] = vpxt_psnr(input.c_str(),
-                    quant_out_enc_arr[file_num].c_str(), 0, PRINT_BTH, 1, 0, 0,
-                    0, NULL, quant_out_enc_art_det_arr[file_num]);
-                tprintf(PRINT_BTH, "\n");
-
-                max_q_verify_arr[file_num] = vpxt_check_max_quantizer(
-                    quant_out_enc_arr[file_num].c_str(), quant_arr[file_num]);
-                tprintf(PRINT_BTH, "\n");
+    // make sure min q is less than the lowest max q
+    while(opt.best_allowed_q > quant_arr[0] && opt.best_allowed_q >= 1)
+        opt.best_allowed_q = quant_arr[0] - 1;
 
-                ++file_num;
-        }
-    }
-    else
+    // Run Test only (Runs Test, Sets up test to be run, or skips compresion of
+    // files), every quantizer is encoded and measured side by side
+    max_q_sweep sweep_arg;
+    sweep_arg.input = input.c_str();
+    sweep_arg.comp_out_str = comp_out_str;
+    sweep_arg.enc_format = enc_format.c_str();
+    sweep_arg.test_type = test_type;
+    sweep_arg.mode = mode;
+    sweep_arg.speed = speed;
+    sweep_arg.bitrate = bitrate;
+    sweep_arg.opt = opt;
+    sweep_arg.quant_out_enc_arr = quant_out_enc_arr;
+    sweep_arg.quant_arr = quant_arr;
+    sweep_arg.art_det_arr = quant_out_enc_art_det_arr;
+    sweep_arg.psnr_arr = psnr_arr;
+    sweep_arg.max_q_verify_arr = max_q_verify_arr;
+
+    int sweep_results[8];
+    VPXT_SWEEP sweep;
+    vpxt_sweep_init(&sweep, 0);
+    vpxt_sweep_run(&sweep, max_q_sweep_job, &sweep_arg, 8, sweep_results);
+    vpxt_sweep_destroy(&sweep);
+
+    for (file_num = 0; file_num < 8; file_num++)
     {
-        file_num = 0;
-        while (file_num < 8)
+        if (sweep_results[file_num] == -1)
         {
-            opt.worst_allowed_q = quant_arr[file_num];
-            // make sure min q is less than max
-            while(opt.best_allowed_q > opt.worst_allowed_q &&
-                opt.best_allowed_q >= 1)
-                opt.best_allowed_q = opt.worst_allowed_q - 1;
-
-            opt.Mode = mode;
-            if (vpxt_compress(input.c_str(), quant_out_enc_arr[file_num].c_str()
-                , speed, bitrate, opt, comp_out_str, quant_arr[file_num], 1,
-                enc_format, kSetConfigOff) == -1)
-            {
-                fclose(fp);
-                record_test_complete(file_index_str, file_index_output_char,
-                    test_type);
-                return kTestIndeterminate;
-            }
-
-            tprintf(PRINT_BTH, "\n");
-
-            if (test_type != kCompOnly)
-            {
-                psnr_arr[file_num] = vpxt_psnr(input.c_str(),
-                    quant_out_enc_arr[file_num].c_str(), 0, PRINT_BTH, 1, 0, 0,
-                    0, NULL, quant_out_enc_art_det_arr[file_num]);
-                tprintf(PRINT_BTH, "\n");
-
-                max_q_verify_arr[file_num] = vpxt_check_max_quantizer(
-                    quant_out_enc_arr[file_num].c_str(), quant_arr[file_num]);
-                tprintf(PRINT_BTH, "\n");
-            }
-
-            ++file_num;
+            fclose(fp);
+            record_test_complete(file_index_str, file_index_output_char,
+                test_type);
+            return kTestIndeterminate;
         }
     }
 
@@ -23,8 +23,8 @@ int test_multithreaded_dec(int argc,
     std::string dec_format = argv[7];
 
     int multithreaded = 0;
-    unsigned int time_0_dec;
-    unsigned int time_n_dec;
+    uint64_t time_0_dec;
+    uint64_t time_n_dec;
 
     if (mode != 0 && mode != 1)
         return vpxt_test_help(argv[1], 0);
@@ -135,17 +135,41 @@ int test_multithreaded_dec(int argc,
         }
     }
 
-    unsigned int dec_cpu_tick_1 = 0;
+    // decode times are compared over repeated runs so only a difference
+    // larger than the run to run noise decides the test
+    VPXT_BENCH_CONFIG bench;
+    VPXT_BENCH_RESULT bench_0_dec;
+    VPXT_BENCH_RESULT bench_n_dec;
+    vpxt_bench_config_init(&bench);
+
     tprintf(PRINT_BTH, "\n\nDec Threads: 0");
-    time_0_dec = vpxt_decompress_time_and_output(multitread_comp_file.c_str(),
-        multithreaded_dec_0.c_str(), dec_cpu_tick_1, dec_format, 0);
-    tprintf(PRINT_BTH, "\nDec time in ms: %i\n", time_0_dec);
-    unsigned int DecCPUTick2 = 0;
+    if (vpxt_bench_time_decompress(&bench, kBenchTime,
+        multitread_comp_file.c_str(), multithreaded_dec_0.c_str(), dec_format,
+        0, &bench_0_dec) == -1)
+    {
+        fclose(fp);
+        record_test_complete(file_index_str, file_index_output_char,
+            test_type);
+        return kTestIndeterminate;
+    }
+
+    time_0_dec = (uint64_t)bench_0_dec.median;
+    tprintf(PRINT_BTH, "\nDec time in ms: %llu\n",
+        (unsigned long long)time_0_dec);
     tprintf(PRINT_BTH, "\n\nDec Threads: %i", core_count);
-    time_n_dec = vpxt_decompress_time_and_output(multitread_comp_file.c_str(),
-        multithreaded_dec_n.c_str(), DecCPUTick2, dec_format,
-        core_count);
-    tprintf(PRINT_BTH, "\nDec time in ms: %i\n", time_n_dec);
+    if (vpxt_bench_time_decompress(&bench, kBenchTime,
+        multitread_comp_file.c_str(), multithreaded_dec_n.c_str(), dec_format,
+        core_count, &bench_n_dec) == -1)
+    {
+        fclose(fp);
+        record_test_complete(file_index_str, file_index_output_char,
+            test_type);
+        return kTestIndeterminate;
+    }
+
+    time_n_dec = (uint64_t)bench_n_dec.median;
+    tprintf(PRINT_BTH, "\nDec time in ms: %llu\n",
+        (unsigned long long)time_n_dec);
 
     // Create Compression only stop test short.
     if (test_type == kCompOnly)
@@ -168,6 +192,11 @@ int test_multithreaded_dec(int argc,
     vpxt_file_name(multithreaded_dec_0.c_str(), time_0_dec_file_name, 0);
     vpxt_file_name(multithreaded_dec_n.c_str(), time_n_dec_file_name, 0);
 
+    double diff_low = 0;
+    double diff_high = 0;
+    int time_diff = vpxt_bench_compare(&bench, &bench_0_dec, &bench_n_dec,
+        &diff_low, &diff_high);
+
     int test_state = kTestPassed;
     tprintf(PRINT_BTH, "\n\nResults:\n\n");
 
@@ -175,42 +204,48 @@ int test_multithreaded_dec(int argc,
     {
         if (time_0_dec == 0)
         {
-            vpxt_formated_print(RESPRT, "%s time: %u = 0 - Failed",
-                time_0_dec_file_name, time_0_dec);
+            vpxt_formated_print(RESPRT, "%s time: %llu = 0 - Failed",
+                time_0_dec_file_name, (unsigned long long)time_0_dec);
             tprintf(PRINT_BTH, "\n");
         }
 
         if (time_n_dec == 0)
         {
-            vpxt_formated_print(RESPRT, "%s time: %u = 0 - Failed",
-                time_n_dec_file_name, time_n_dec);
+            vpxt_formated_print(RESPRT, "%s time: %llu = 0 - Failed",
+                time_n_dec_file_name, (unsigned long long)time_n_dec);
         }
 
         test_state = kTestFailed;
     }
 
-    if (time_n_dec < time_0_dec)
+    if (time_diff < 0)
     {
-        vpxt_formated_print(RESPRT, "%s time: %u < %s time: %u - Passed",
-            time_n_dec_file_name, time_n_dec, time_0_dec_file_name, time_0_dec);
+        vpxt_formated_print(RESPRT, "%s time: %llu < %s time: %llu by %.1f%% "
+            "to %.1f%% - Passed", time_n_dec_file_name,
+            (unsigned long long)time_n_dec, time_0_dec_file_name,
+            (unsigned long long)time_0_dec, -100 * diff_high, -100 * diff_low);
         tprintf(PRINT_BTH, "\n");
     }
 
-    if (time_0_dec == time_n_dec)
+    if (time_diff == 0)
     {
-        vpxt_formated_print(RESPRT, "%s time: %u == %s time: %u - Indeterminate"
-            , time_0_dec_file_name, time_0_dec, time_n_dec_file_name,
-            time_n_dec);
+        vpxt_formated_print(RESPRT, "%s time: %llu and %s time: %llu differ "
+            "by %.1f%% to %.1f%%, not significant - Indeterminate",
+            time_0_dec_file_name, (unsigned long long)time_0_dec,
+            time_n_dec_file_name, (unsigned long long)time_n_dec,
+            100 * diff_low, 100 * diff_high);
         tprintf(PRINT_BTH, "\n");
 
         if (test_state != kTestFailed)
             test_state = kTestIndeterminate;
     }
 
-    if (time_n_dec > time_0_dec)
+    if (time_diff > 0)
     {
-        vpxt_formated_print(RESPRT, "%s time: %u > %s time: %u - Failed",
-            time_n_dec_file_name, time_n_dec, time_0_dec_file_name, time_0_dec);
+        vpxt_formated_print(RESPRT, "%s time: %llu > %s time: %llu by %.1f%% "
+            "to %.1f%% - Failed", time_n_dec_file_name,
+            (unsigned long long)time_n_dec, time_0_dec_file_name,
+            (unsigned long long)time_0_dec, 100 * diff_low, 100 * diff_high);
         tprintf(PRINT_BTH, "\n");
         test_state = kTestFailed;
     }
@@ -22,8 +22,8 @@ int test_multithreaded_enc(int argc,
     std::string enc_format = argv[6];
 
     int multithreaded = 0;
-    unsigned int time_1;
-    unsigned int time_2;
+    uint64_t time_1;
+    uint64_t time_2;
 
     if (mode != 0 && mode != 1)
         return vpxt_test_help(argv[1], 0);
@@ -89,12 +89,12 @@ int test_multithreaded_enc(int argc,
             opt.Mode = MODE_REALTIME;
             opt.multi_threaded = core_count;
             opt.cpu_used = -1;
-            unsigned int cpu_tick_1 = 0;
+            uint64_t cpu_tick_1 = 0;
             time_1 = vpxt_time_compress(input.c_str(),
                 multithreaded_on_comp.c_str(), multithreaded, bitrate, opt,
                 comp_out_str, opt.multi_threaded, 0, cpu_tick_1, enc_format);
 
-            if (time_1 == -1)
+            if (time_1 == (uint64_t)-1)
             {
                 fclose(fp);
                 record_test_complete(file_index_str, file_index_output_char,
@@ -104,12 +104,12 @@ int test_multithreaded_enc(int argc,
 
             opt.Mode = MODE_REALTIME;
             opt.multi_threaded = 0;
-            unsigned int cpu_tick_2 = 0;
+            uint64_t cpu_tick_2 = 0;
             time_2 = vpxt_time_compress(input.c_str(),
                 multithreaded_off_comp.c_str(), multithreaded, bitrate, opt,
                 comp_out_str, opt.multi_threaded, 0, cpu_tick_2, enc_format);
 
-            if (time_2 == -1)
+            if (time_2 == (uint64_t)-1)
             {
                 fclose(fp);
                 record_test_complete(file_index_str, file_index_output_char,
@@ -122,12 +122,12 @@ int test_multithreaded_enc(int argc,
         {
             opt.Mode = MODE_GOODQUALITY;
             opt.multi_threaded = core_count;
-            unsigned int cpu_tick_1 = 0;
+            uint64_t cpu_tick_1 = 0;
             time_1 = vpxt_time_compress(input.c_str(),
                 multithreaded_on_comp.c_str(), multithreaded, bitrate, opt,
                 comp_out_str, opt.multi_threaded, 0, cpu_tick_1, enc_format);
 
-            if (time_1 == -1)
+            if (time_1 == (uint64_t)-1)
             {
                 fclose(fp);
                 record_test_complete(file_index_str, file_index_output_char,
@@ -137,12 +137,12 @@ int test_multithreaded_enc(int argc,
 
             opt.Mode = MODE_GOODQUALITY;
             opt.multi_threaded = 0;
-            unsigned int cpu_tick_2 = 0;
+            uint64_t cpu_tick_2 = 0;
             time_2 = vpxt_time_compress(input.c_str(),
                 multithreaded_off_comp.c_str(), multithreaded, bitrate, opt,
                 comp_out_str, opt.multi_threaded, 0, cpu_tick_2, enc_format);
 
-            if (time_2 == -1)
+            if (time_2 == (uint64_t)-1)
             {
                 fclose(fp);
                 record_test_complete(file_index_str, file_index_output_char,
@@ -173,34 +173,37 @@ int test_multithreaded_enc(int argc,
     if (time_1 == 0 || time_2 == 0)
     {
         if (time_1 == 0)
-            vpxt_formated_print(RESPRT, "%s time: %u = 0 - Failed",
-            time_1_file_name, time_1);
+            vpxt_formated_print(RESPRT, "%s time: %llu = 0 - Failed",
+            time_1_file_name, (unsigned long long)time_1);
 
         if (time_2 == 0)
-            vpxt_formated_print(RESPRT, "%s time: %u = 0 - Failed",
-            time_2_file_name, time_2);
+            vpxt_formated_print(RESPRT, "%s time: %llu = 0 - Failed",
+            time_2_file_name, (unsigned long long)time_2);
     }
 
     if (time_1 < time_2 && !(time_1 == 0 || time_2 == 0))
     {
-        vpxt_formated_print(RESPRT, "%s time: %u < %s time2: %u - Passed",
-            time_1_file_name, time_1, time_2_file_name, time_2);
+        vpxt_formated_print(RESPRT, "%s time: %llu < %s time2: %llu - "
+            "Passed", time_1_file_name, (unsigned long long)time_1,
+            time_2_file_name, (unsigned long long)time_2);
 
         test_state = kTestPassed;
     }
 
     if (time_1 == time_2 && !(time_1 == 0 || time_2 == 0))
     {
-        vpxt_formated_print(RESPRT, "%s time: %u == %s time: %u - Indeterminate"
-            , time_1_file_name, time_1, time_2_file_name, time_2);
+        vpxt_formated_print(RESPRT, "%s time: %llu == %s time: %llu - "
+            "Indeterminate", time_1_file_name, (unsigned long long)time_1,
+            time_2_file_name, (unsigned long long)time_2);
 
         test_state = kTestIndeterminate;
     }
 
     if (time_1 > time_2 && !(time_1 == 0 || time_2 == 0))
     {
-        vpxt_formated_print(RESPRT, "%s time: %u > %s time: %u - Failed",
-            time_1_file_name, time_1, time_2_file_name, time_2);
+        vpxt_formated_print(RESPRT, "%s time: %llu > %s time: %llu - "
+            "Failed", time_1_file_name, (unsigned long long)time_1,
+            time_2_file_name, (unsigned long long)time_2);
     }
 
     if(test_state == kTestPassed)
@@ -22,8 +22,8 @@ int test_new_vs_old_enc_cpu_tick(int argc,
     std::string enc_format = argv[7];
 
     int speed = 0;
-    unsigned int cpu_tick_new = 0;
-    unsigned int cpu_tick_old = 0;
+    uint64_t cpu_tick_new = 0;
+    uint64_t cpu_tick_old = 0;
 
     //////////// Formatting Test Specific directory ////////////
     std::string cur_test_dir_str;
@@ -143,17 +143,19 @@ int test_new_vs_old_enc_cpu_tick(int argc,
             cpu_tick_new = vpxt_cpu_tick_return(new_enc_file.c_str(), 0);
             cpu_tick_old = vpxt_cpu_tick_return(old_enc_file.c_str(), 0);
 
-            tprintf(PRINT_BTH, "\ncpu_tick_new: %i\n", cpu_tick_new);
-            tprintf(PRINT_BTH, "\ncpu_tick_old: %i\n", cpu_tick_old);
+            tprintf(PRINT_BTH, "\ncpu_tick_new: %llu\n",
+                (unsigned long long)cpu_tick_new);
+            tprintf(PRINT_BTH, "\ncpu_tick_old: %llu\n",
+                (unsigned long long)cpu_tick_old);
         }
         else
         {
             opt.Mode = mode;
-            unsigned int time = vpxt_time_compress(input.c_str(),
+            uint64_t time = vpxt_time_compress(input.c_str(),
                 new_enc_file.c_str(), speed, bitrate, opt, "VP8", 0, 0,
                 cpu_tick_new, enc_format);
 
-            if (time == -1 || time == 0)
+            if (time == (uint64_t)-1 || time == 0)
             {
                 fclose(fp);
                 record_test_complete(file_index_str, file_index_output_char,
@@ -163,7 +165,7 @@ int test_new_vs_old_enc_cpu_tick(int argc,
         }
 
         char cpu_tick_new_char[256];
-        sprintf(cpu_tick_new_char, "%u", cpu_tick_new);
+        sprintf(cpu_tick_new_char, "%llu", (unsigned long long)cpu_tick_new);
 
         std::string time_result_str;
         time_result_str += cpu_tick_new_char;
@@ -284,17 +286,19 @@ int test_new_vs_old_enc_cpu_tick(int argc,
             cpu_tick_new = vpxt_cpu_tick_return(new_enc_file.c_str(), 0);
             cpu_tick_old = vpxt_cpu_tick_return(old_enc_file.c_str(), 0);
 
-            tprintf(PRINT_BTH, "\ncpu_tick_new: %i\n", cpu_tick_new);
-            tprintf(PRINT_BTH, "\ncpu_tick_old: %i\n", cpu_tick_old);
+            tprintf(PRINT_BTH, "\ncpu_tick_new: %llu\n",
+                (unsigned long long)cpu_tick_new);
+            tprintf(PRINT_BTH, "\ncpu_tick_old: %llu\n",
+                (unsigned long long)cpu_tick_old);
         }
         else
         {
             opt.Mode = mode;
-            unsigned int time = vpxt_time_compress(input.c_str(),
+            uint64_t time = vpxt_time_compress(input.c_str(),
                 new_enc_file.c_str(), speed, bitrate, opt, "VP8", 0, 0,
                 cpu_tick_new, enc_format);
 
-            if (time == -1)
+            if (time == (uint64_t)-1)
             {
                 fclose(fp);
                 record_test_complete(file_index_str, file_index_output_char,
@@ -317,28 +321,32 @@ int test_new_vs_old_enc_cpu_tick(int argc,
             fprintf(stderr, " ");
 
             vpxt_run_exe(comand_line_str);
-            unsigned int time2 = vpxt_time_return(old_enc_file.c_str(), 0);
+            uint64_t time2 = vpxt_time_return(old_enc_file.c_str(), 0);
             cpu_tick_old = vpxt_cpu_tick_return(old_enc_file.c_str(), 0);
 
-            tprintf(PRINT_BTH, "\n\nFile completed: time in Microseconds: %u",
-                time2);
-            tprintf(PRINT_BTH, "\n Total CPU Ticks: %u\n", cpu_tick_old);
+            tprintf(PRINT_BTH, "\n\nFile completed: time in Microseconds: %llu",
+                (unsigned long long)time2);
+            tprintf(PRINT_BTH, "\n Total CPU Ticks: %llu\n",
+                (unsigned long long)cpu_tick_old);
         }
 
         tprintf(PRINT_BTH, "\n\n\nResults:\n\n");
 
         if (cpu_tick_new < cpu_tick_old)
-            vpxt_formated_print(RESPRT, "New: %u is Faster than Old: %u - "
-                "Passed", cpu_tick_new, cpu_tick_old);
+            vpxt_formated_print(RESPRT, "New: %llu is Faster than Old: %llu - "
+                "Passed", (unsigned long long)cpu_tick_new,
+                (unsigned long long)cpu_tick_old);
         else if (cpu_tick_new < (cpu_tick_old + (cpu_tick_old * .05)))
-            vpxt_formated_print(RESPRT, "New: %u is with in five percent of Old"
-            ": %u - Passed", cpu_tick_new, cpu_tick_old);
+            vpxt_formated_print(RESPRT, "New: %llu is with in five percent of "
+            "Old: %llu - Passed", (unsigned long long)cpu_tick_new,
+            (unsigned long long)cpu_tick_old);
         else if (cpu_tick_new == cpu_tick_old)
             vpxt_formated_print(RESPRT, "Files Took the same amount of time - "
                 "Passed");
         else if (cpu_tick_new > cpu_tick_old){
-            vpxt_formated_print(RESPRT, "Old: %u is Faster than New: %u -"
-                " Failed",cpu_tick_old, cpu_tick_new);
+            vpxt_formated_print(RESPRT, "Old: %llu is Faster than New: %llu -"
+                " Failed", (unsigned long long)cpu_tick_old,
+                (unsigned long long)cpu_tick_new);
 
             test_state = kTestFailed;
         }
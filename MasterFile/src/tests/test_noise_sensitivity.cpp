@@ -115,9 +115,14 @@ int test_noise_sensitivity(int argc,
             opt.Mode = mode;
             opt.noise_sensitivity = noise;
 
+            // psnr is measured while encoding
+            VPXT_ENCODE_PSNR enc_psnr;
+            vpxt_encode_psnr_init(&enc_psnr, PRINT_BTH, 0,
+                noise_sense_art_det[noise]);
+
             if (vpxt_compress(input.c_str(), noise_sense_vec[noise].c_str(),
                 speed, bit_rate, opt, comp_out_str, noise, 0, enc_format,
-                kSetConfigOff)== -1)
+                kSetConfigOff, test_type != 2 ? &enc_psnr : NULL)== -1)
             {
                 fclose(fp);
                 record_test_complete(file_index_str, file_index_output_char,
@@ -127,10 +132,8 @@ int test_noise_sensitivity(int argc,
 
             if (test_type != 2)
             {
-                tprintf(PRINT_BTH, "\n");
-                noise_psnr[noise] = vpxt_psnr(input.c_str(),
-                    noise_sense_vec[noise].c_str(), 0, PRINT_BTH, 1, 0, 0, 0,
-                    NULL, noise_sense_art_det[noise]);
+                noise_psnr[noise] = enc_psnr.psnr;
+                noise_sense_art_det[noise] = enc_psnr.potential_artifact;
                 tprintf(PRINT_BTH, "\n");
                 file_size[noise] = vpxt_file_size(
                     noise_sense_vec[noise].c_str(), 1);
@@ -1,4 +1,5 @@
 #include "vpxt_test_declarations.h"
+#include "vpxt_frame_scan.h"
 
 int test_play_alternate(int argc,
                         const char** argv,
@@ -116,14 +117,20 @@ int test_play_alternate(int argc,
 
     int test_state = kTestPassed;
 
-    int play_alternate_on_alt_ref_count =
-        vpxt_display_alt_ref_frames(play_alternate_2.c_str(), 1);
-    int play_alternate_off_alt_ref_count =
-        vpxt_display_alt_ref_frames(play_alternate_1.c_str(), 1);
-    int visible_frame_on_count =
-        vpxt_display_visible_frames(play_alternate_2.c_str(), 1);
-    int visible_frame_off_count =
-        vpxt_display_visible_frames(play_alternate_1.c_str(), 1);
+    VPXT_FRAME_SCAN scan_on;
+    vpxt_frame_scan_init(&scan_on, VPXT_SCAN_ALT_REF | VPXT_SCAN_VISIBLE);
+    vpxt_frame_scan(play_alternate_2.c_str(), &scan_on);
+    vpxt_frame_scan_write(play_alternate_2.c_str(), &scan_on);
+
+    VPXT_FRAME_SCAN scan_off;
+    vpxt_frame_scan_init(&scan_off, VPXT_SCAN_ALT_REF | VPXT_SCAN_VISIBLE);
+    vpxt_frame_scan(play_alternate_1.c_str(), &scan_off);
+    vpxt_frame_scan_write(play_alternate_1.c_str(), &scan_off);
+
+    int play_alternate_on_alt_ref_count = scan_on.alt_ref_frames.size();
+    int play_alternate_off_alt_ref_count = scan_off.alt_ref_frames.size();
+    int visible_frame_on_count = scan_on.visible_frames.size();
+    int visible_frame_off_count = scan_off.visible_frames.size();
 
     char play_alternate_on_file_name[255];
     vpxt_file_name(play_alternate_2.c_str(), play_alternate_on_file_name, 0);
@@ -1,4 +1,5 @@
 #include "vpxt_test_declarations.h"
+#include "vpxt_frame_scan.h"
 
 int test_resample_down_watermark(int argc,
                                  const char** argv,
@@ -119,42 +120,47 @@ int test_resample_down_watermark(int argc,
     vpxt_file_name(down_water_sample_90_comp.c_str(),
         down_water_sample_90_file_name, 0);
 
-    int disp_key_frames_20 =
-        vpxt_display_key_frames(down_water_sample_20_comp.c_str(), 1);
-    int disp_resized_frames_20 =
-        vpxt_display_resized_frames(down_water_sample_20_comp.c_str(), 1);
-    int disp_check_pbm_20 =
-        vpxt_check_pbm_threshold(down_water_sample_20_comp.c_str(),
-        opt.target_bandwidth, opt.maximum_buffer_size * 1000,
-        opt.starting_buffer_level * 1000, opt.optimal_buffer_level * 1000,
-        resample_down_water_low);
+    // key frames, resized frames and buffer levels from one pass
+    VPXT_FRAME_SCAN scan_20;
+    vpxt_frame_scan_init(&scan_20, VPXT_SCAN_DFWM);
+    scan_20.bitrate = opt.target_bandwidth;
+    scan_20.max_buffer = opt.maximum_buffer_size * 1000;
+    scan_20.pre_buffer = opt.starting_buffer_level * 1000;
+    scan_20.optimal_buffer = opt.optimal_buffer_level * 1000;
+    scan_20.threshold = resample_down_water_low;
+    vpxt_frame_scan(down_water_sample_20_comp.c_str(), &scan_20);
+    vpxt_frame_scan_write(down_water_sample_20_comp.c_str(), &scan_20);
+
+    int disp_resized_frames_20 = scan_20.resized_frames.size();
     int rdwm_check_20 = 0;
 
     if (disp_resized_frames_20 > 0)
     {
         tprintf(PRINT_STD, "\nChecking %s buffer for correct resize frame "
             "placement:\n\n", down_water_sample_20_file_name);
-        rdwm_check_20 = vpxt_dfwm_check(down_water_sample_20_comp.c_str(), 1);
+        rdwm_check_20 = vpxt_frame_scan_dfwm_check(&scan_20, 1);
     }
     else
         rdwm_check_20 = -2;
 
-    int disp_key_frames_90 =
-        vpxt_display_key_frames(down_water_sample_90_comp.c_str(), 1);
-    int disp_resized_frames_90 =
-        vpxt_display_resized_frames(down_water_sample_90_comp.c_str(), 1);
-    int disp_check_pbm_90 =
-        vpxt_check_pbm_threshold(down_water_sample_90_comp.c_str(),
-        opt.target_bandwidth, opt.maximum_buffer_size * 1000,
-        opt.starting_buffer_level * 1000, opt.optimal_buffer_level * 1000,
-        resample_down_water_high);
+    VPXT_FRAME_SCAN scan_90;
+    vpxt_frame_scan_init(&scan_90, VPXT_SCAN_DFWM);
+    scan_90.bitrate = opt.target_bandwidth;
+    scan_90.max_buffer = opt.maximum_buffer_size * 1000;
+    scan_90.pre_buffer = opt.starting_buffer_level * 1000;
+    scan_90.optimal_buffer = opt.optimal_buffer_level * 1000;
+    scan_90.threshold = resample_down_water_high;
+    vpxt_frame_scan(down_water_sample_90_comp.c_str(), &scan_90);
+    vpxt_frame_scan_write(down_water_sample_90_comp.c_str(), &scan_90);
+
+    int disp_resized_frames_90 = scan_90.resized_frames.size();
     int rdwm_check_90 = -3;
 
     if (disp_resized_frames_90 > 0)
     {
         tprintf(PRINT_STD, "\nChecking %s buffer for correct resize frame "
             "placement:\n\n", down_water_sample_90_file_name);
-        rdwm_check_90 = vpxt_dfwm_check(down_water_sample_90_comp.c_str(), 1);
+        rdwm_check_90 = vpxt_frame_scan_dfwm_check(&scan_90, 1);
     }
     else
         rdwm_check_90 = -2;
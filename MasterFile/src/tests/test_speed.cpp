@@ -1,8 +1,51 @@
 #include "vpxt_test_declarations.h"
+#include "vpxt_sweep.h"
 
 #define max_real_time_value 16
 #define max_good_quality_value 6
 
+// Reads back the timing and measures the psnr of one existing encode per
+// sweep job.  The timed encodes themselves stay one after another.
+struct speed_test_only_sweep
+{
+    const char *input;
+    std::string *str_arr;
+    int *art_det;
+    const VPXT_BENCH_CONFIG *bench;
+    int metric;
+    VPXT_BENCH_RESULT *bench_arr;
+    double *psnr_arr;
+};
+
+static int speed_test_only_sweep_job(void *arg, int counter)
+{
+    speed_test_only_sweep *sweep = (speed_test_only_sweep *)arg;
+
+    vpxt_bench_return(sweep->str_arr[counter].c_str(), 0, sweep->metric,
+        sweep->bench, &sweep->bench_arr[counter]);
+    sweep->psnr_arr[counter] = vpxt_psnr(sweep->input,
+        sweep->str_arr[counter].c_str(), 1, PRINT_BTH, 1, 0, 0, 0, NULL,
+        sweep->art_det[counter]);
+
+    return 0;
+}
+
+// Speed is gated on the total cpu ticks of a single encode per setting.
+// With VPXT_SPEED_P99 set every encode is benchmarked as bench asks and
+// gated on its p99 frame latency instead.
+static int speed_gate_metric(VPXT_BENCH_CONFIG *bench)
+{
+    const char *env = getenv("VPXT_SPEED_P99");
+
+    if (env && *env && atoi(env))
+        return kBenchLatencyP99;
+
+    bench->warmup = 0;
+    bench->repetitions = 1;
+
+    return kBenchCpuTick;
+}
+
 int test_speed(int argc,
                const char** argv,
                const std::string &working_dir,
@@ -108,8 +151,11 @@ int test_speed(int argc,
 
     tprintf(PRINT_BTH, "\nLagInFrames: %i\n", lag_in_frames_input);
 
-    unsigned int good_quality_total_cpu_tick[max_good_quality_value];
-    unsigned int real_time_total_cpu_tick[max_real_time_value];
+    VPXT_BENCH_CONFIG bench;
+    VPXT_BENCH_RESULT good_quality_bench[max_good_quality_value];
+    VPXT_BENCH_RESULT real_time_bench[max_real_time_value];
+    vpxt_bench_config_init(&bench);
+    int gate_metric = speed_gate_metric(&bench);
 
     double good_quality_psnr_arr[max_good_quality_value];
     double real_time_psnr_arr[max_real_time_value];
@@ -118,42 +164,33 @@ int test_speed(int argc,
     // files)
     if (test_type == kTestOnly)
     {
-        speed_counter = 0; // array counter same as speed counter
+        speed_test_only_sweep sweep_arg;
+        sweep_arg.input = input.c_str();
+        sweep_arg.bench = &bench;
+        sweep_arg.metric = gate_metric;
 
         if (mode == kOnePassGoodQuality)
         {
-            while (speed_counter < max_good_quality_value)
-            {
-                good_quality_total_cpu_tick[speed_counter] =
-                    vpxt_cpu_tick_return(
-                    speed_test_good_quality_str_arr[speed_counter].c_str(),0);
-                good_quality_psnr_arr[speed_counter] =
-                    vpxt_psnr(input.c_str(),
-                    speed_test_good_quality_str_arr[speed_counter].c_str() , 1,
-                    PRINT_BTH, 1, 0, 0, 0, NULL,
-                    speed_test_good_quality_art_det[speed_counter]);
-
-                speed_counter++;
-            }
+            sweep_arg.str_arr = speed_test_good_quality_str_arr;
+            sweep_arg.art_det = speed_test_good_quality_art_det;
+            sweep_arg.bench_arr = good_quality_bench;
+            sweep_arg.psnr_arr = good_quality_psnr_arr;
+            counter = max_good_quality_value;
         }
-
-        if (mode == kRealTime)
+        else
         {
-            counter = 0; // array counter
-
-            while (counter > -1 * max_real_time_value)
-            {
-                real_time_total_cpu_tick[counter] =
-                    vpxt_cpu_tick_return(
-                    speed_test_real_time_str_arr[counter].c_str(), 0);
-                real_time_psnr_arr[counter] =
-                    vpxt_psnr(input.c_str(),
-                    speed_test_real_time_str_arr[counter].c_str(),1, PRINT_BTH,
-                    1, 0, 0, 0, NULL, speed_test_real_time_art_det[counter]);
-
-                counter++;
-            }
+            sweep_arg.str_arr = speed_test_real_time_str_arr;
+            sweep_arg.art_det = speed_test_real_time_art_det;
+            sweep_arg.bench_arr = real_time_bench;
+            sweep_arg.psnr_arr = real_time_psnr_arr;
+            counter = max_real_time_value;
         }
+
+        VPXT_SWEEP sweep;
+        vpxt_sweep_init(&sweep, 0);
+        vpxt_sweep_run(&sweep, speed_test_only_sweep_job, &sweep_arg, counter,
+            NULL);
+        vpxt_sweep_destroy(&sweep);
     }
     else
     {
@@ -166,10 +203,19 @@ int test_speed(int argc,
                 opt.cpu_used = speed_counter;
                 compress_int = opt.cpu_used;
                 opt.Mode = MODE_GOODQUALITY;
-                unsigned int time = vpxt_time_compress(input.c_str(),
+
+                // psnr is measured from the encoded frames once timing is done
+                VPXT_ENCODE_PSNR enc_psnr;
+                vpxt_encode_psnr_init(&enc_psnr, PRINT_BTH, 0,
+                    speed_test_good_quality_art_det[speed_counter]);
+
+                int time = vpxt_bench_time_compress(&bench, gate_metric,
+                    input.c_str(),
                     speed_test_good_quality_str_arr[speed_counter].c_str(),
                     speed, bitrate, opt, comp_out_str, compress_int, 0,
-                    good_quality_total_cpu_tick[speed_counter], enc_format);
+                    enc_format,
+                    test_type != 2 && test_type != 3 ? &enc_psnr : NULL,
+                    &good_quality_bench[speed_counter]);
 
                 if (time == -1)
                 {
@@ -181,11 +227,9 @@ int test_speed(int argc,
 
                 if (test_type != 2 && test_type != 3)
                 {
-                    good_quality_psnr_arr[speed_counter] = vpxt_psnr(
-                        input.c_str(),
-                        speed_test_good_quality_str_arr[speed_counter].c_str(),
-                        1, PRINT_BTH, 1, 0, 0, 0, NULL,
-                        speed_test_good_quality_art_det[speed_counter]);
+                    good_quality_psnr_arr[speed_counter] = enc_psnr.psnr;
+                    speed_test_good_quality_art_det[speed_counter] =
+                        enc_psnr.potential_artifact;
                 }
 
                 speed_counter++;
@@ -202,10 +246,18 @@ int test_speed(int argc,
                 opt.cpu_used = speed_counter;
                 compress_int = opt.cpu_used;
                 opt.Mode = MODE_REALTIME;
-                unsigned int time = vpxt_time_compress(input.c_str(),
+
+                VPXT_ENCODE_PSNR enc_psnr;
+                vpxt_encode_psnr_init(&enc_psnr, PRINT_BTH, 0,
+                    speed_test_real_time_art_det[counter]);
+
+                int time = vpxt_bench_time_compress(&bench, gate_metric,
+                    input.c_str(),
                     speed_test_real_time_str_arr[counter].c_str(), speed,
                     bitrate, opt, comp_out_str, compress_int, 0,
-                    real_time_total_cpu_tick[counter], enc_format);
+                    enc_format,
+                    test_type != 2 && test_type != 3 ? &enc_psnr : NULL,
+                    &real_time_bench[counter]);
 
                 if (time == -1)
                 {
@@ -217,10 +269,9 @@ int test_speed(int argc,
 
                 if (test_type != 2 && test_type != 3)
                 {
-                    real_time_psnr_arr[counter] = vpxt_psnr(input.c_str(),
-                        speed_test_real_time_str_arr[counter].c_str(), 1,
-                        PRINT_BTH, 1, 0, 0, 0, NULL,
-                        speed_test_real_time_art_det[counter]);
+                    real_time_psnr_arr[counter] = enc_psnr.psnr;
+                    speed_test_real_time_art_det[counter] =
+                        enc_psnr.potential_artifact;
                 }
 
                 speed_counter--;
@@ -237,6 +288,36 @@ int test_speed(int argc,
         return kTestEncCreated;
     }
 
+    // runs gated on p99 without latency files fall back to total cpu ticks
+    int gate_count = mode == kRealTime ? max_real_time_value :
+        max_good_quality_value;
+    std::string *gate_str_arr = mode == kRealTime ?
+        speed_test_real_time_str_arr : speed_test_good_quality_str_arr;
+    VPXT_BENCH_RESULT *gate_arr = mode == kRealTime ? real_time_bench :
+        good_quality_bench;
+    const char *gate_name = "p99";
+    const char *gate_results = "p99 frame latencies";
+
+    for (counter = 0; counter < gate_count; counter++)
+        if (!gate_arr[counter].count)
+            break;
+
+    if (gate_metric == kBenchCpuTick)
+    {
+        gate_name = "Tick";
+        gate_results = "ticks";
+    }
+
+    if (gate_metric != kBenchCpuTick && counter < gate_count)
+    {
+        gate_name = "Tick";
+        gate_results = "ticks";
+
+        for (counter = 0; counter < gate_count; counter++)
+            vpxt_bench_return(gate_str_arr[counter].c_str(), 0, kBenchCpuTick,
+                &bench, &gate_arr[counter]);
+    }
+
     tprintf(PRINT_BTH, "\n");
     speed_counter = 1;
     int test_state = kTestPassed;
@@ -245,20 +326,30 @@ int test_speed(int argc,
     {
         while (speed_counter < max_good_quality_value)
         {
-            if (good_quality_total_cpu_tick[speed_counter] <
-                good_quality_total_cpu_tick[speed_counter-1])
+            double diff_low;
+            double diff_high;
+            int speed_diff = vpxt_bench_compare(&bench,
+                &gate_arr[speed_counter-1], &gate_arr[speed_counter],
+                &diff_low, &diff_high);
+
+            // only a significantly slower encode fails
+            if (speed_diff <= 0)
             {
-                tprintf(PRINT_BTH, "      CpuUsed %*i Encode Tick: %i < CpuUsed"
-                    " %*i Encode Tick: %i\n", 2, speed_counter,
-                    good_quality_total_cpu_tick[speed_counter], 2, speed_counter
-                    - 1, good_quality_total_cpu_tick[speed_counter-1]);
+                tprintf(PRINT_BTH, "      CpuUsed %*i Encode %s: %.0f %s "
+                    "CpuUsed %*i Encode %s: %.0f (%.1f%% to %.1f%%)\n", 2,
+                    speed_counter, gate_name, gate_arr[speed_counter].median,
+                    speed_diff < 0 ? "<" : "~", 2, speed_counter - 1,
+                    gate_name, gate_arr[speed_counter-1].median,
+                    100 * diff_low, 100 * diff_high);
             }
             else
             {
-                tprintf(PRINT_BTH, "Fail: CpuUsed %*i Encode Tick: %i > "
-                    "CpuUsed %*i Encode Tick: %i\n", 2, speed_counter,
-                    good_quality_total_cpu_tick[speed_counter], 2, speed_counter
-                    - 1, good_quality_total_cpu_tick[speed_counter-1]);
+                tprintf(PRINT_BTH, "Fail: CpuUsed %*i Encode %s: %.0f > "
+                    "CpuUsed %*i Encode %s: %.0f (%.1f%% to %.1f%%)\n", 2,
+                    speed_counter, gate_name, gate_arr[speed_counter].median,
+                    2, speed_counter - 1, gate_name,
+                    gate_arr[speed_counter-1].median, 100 * diff_low,
+                    100 * diff_high);
                 fail_1 = 1;
             }
 
@@ -291,30 +382,34 @@ int test_speed(int argc,
     {
         while (speed_counter < max_real_time_value)
         {
-            if (real_time_total_cpu_tick[speed_counter] <
-                real_time_total_cpu_tick[speed_counter-1])
+            double diff_low;
+            double diff_high;
+            int speed_diff = vpxt_bench_compare(&bench,
+                &gate_arr[speed_counter-1], &gate_arr[speed_counter],
+                &diff_low, &diff_high);
+
+            if (speed_diff <= 0)
             {
-                tprintf(PRINT_BTH, "      CpuUsed -%*i Encode Tick: %i < "
-                    "CpuUsed -%*i Encode Tick: %i\n", 2, speed_counter + 1,
-                    real_time_total_cpu_tick[speed_counter], 2, speed_counter,
-                    real_time_total_cpu_tick[speed_counter-1]);
+                tprintf(PRINT_BTH, "      CpuUsed -%*i Encode %s: %.0f %s "
+                    "CpuUsed -%*i Encode %s: %.0f (%.1f%% to %.1f%%)\n", 2,
+                    speed_counter + 1, gate_name,
+                    gate_arr[speed_counter].median, speed_diff < 0 ? "<" : "~",
+                    2, speed_counter, gate_name,
+                    gate_arr[speed_counter-1].median, 100 * diff_low,
+                    100 * diff_high);
             }
             else
             {
-                tprintf(PRINT_BTH, "FAIL: CpuUsed -%*i Encode Tick: %i > "
-                    "CpuUsed -%*i Encode Tick: %i\n", 2, speed_counter + 1,
-                    real_time_total_cpu_tick[speed_counter], 2, speed_counter,
-                    real_time_total_cpu_tick[speed_counter-1]);
+                tprintf(PRINT_BTH, "FAIL: CpuUsed -%*i Encode %s: %.0f > "
+                    "CpuUsed -%*i Encode %s: %.0f (%.1f%% to %.1f%%)\n", 2,
+                    speed_counter + 1, gate_name,
+                    gate_arr[speed_counter].median, 2, speed_counter,
+                    gate_name, gate_arr[speed_counter-1].median,
+                    100 * diff_low, 100 * diff_high);
                 fail_1++;
 
-                double time_percent = (real_time_total_cpu_tick[speed_counter] -
-                    real_time_total_cpu_tick[speed_counter-1]);
-
-                if (time_percent < 0)
-                    time_percent = time_percent * (-1);
-
-                if (time_percent > (real_time_total_cpu_tick[speed_counter-1] /
-                    10))
+                // even the low end of the interval is more than 10% slower
+                if (diff_low > 0.1)
                     fail_3++;
             }
 
@@ -351,23 +446,23 @@ int test_speed(int argc,
 
         if (fail_1 == 0)
         {
-            vpxt_formated_print(RESPRT, "All encode ticks decrease as CpuUsed "
-                "increases - Passed");
+            vpxt_formated_print(RESPRT, "All encode %s decrease as CpuUsed "
+                "increases - Passed", gate_results);
             tprintf(PRINT_BTH, "\n");
         }
 
         if (fail_1 < 4 && fail_1 != 0)
         {
-            vpxt_formated_print(RESPRT, "Enough encode ticks decrease as "
-                "CpuUsed increases - Min Passed");
+            vpxt_formated_print(RESPRT, "Enough encode %s decrease as "
+                "CpuUsed increases - Min Passed", gate_results);
             tprintf(PRINT_BTH, "\n");
             test_state = kTestMinPassed;
         }
 
         if (fail_1 >= 4)
         {
-            vpxt_formated_print(RESPRT, "Not enough encode ticks decrease as "
-                "CpuUsed increases - Failed");
+            vpxt_formated_print(RESPRT, "Not enough encode %s decrease as "
+                "CpuUsed increases - Failed", gate_results);
             tprintf(PRINT_BTH, "\n");
             test_state = kTestFailed;
         }
@@ -409,15 +504,15 @@ int test_speed(int argc,
 
         if (fail_1 == 1)
         {
-            vpxt_formated_print(RESPRT, "Not all encode ticks decrease as "
-                "CpuUsed increases - Failed");
+            vpxt_formated_print(RESPRT, "Not all encode %s decrease as "
+                "CpuUsed increases - Failed", gate_results);
             tprintf(PRINT_BTH, "\n");
             test_state = kTestFailed;
         }
         else
         {
-            vpxt_formated_print(RESPRT, "All encode ticks decrease as CpuUsed "
-                "increases - Passed");
+            vpxt_formated_print(RESPRT, "All encode %s decrease as CpuUsed "
+                "increases - Passed", gate_results);
             tprintf(PRINT_BTH, "\n");
         }
 
@@ -187,7 +187,7 @@ int test_temporal_scalability(int argc,
     int_it = enc_vec_art_det.begin();
     for(str_it = enc_vec.begin(); str_it < enc_vec.end(); ++str_it)
     {
-        unsigned int cpu_tick = 0;
+        uint64_t cpu_tick = 0;
         opt.target_bandwidth = temp_bitrate_arr[j];
         enc_compress_time = vpxt_time_compress(input.c_str(), (*str_it).c_str(),
             0, temp_bitrate_arr[j], opt, comp_out_str, 0, 0, cpu_tick,
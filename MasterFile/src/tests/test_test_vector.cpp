@@ -1,7 +1,50 @@
 #include "vpxt_test_declarations.h"
+#include "vpxt_sweep.h"
 
 #define max_test_vector 102
 
+// Decodes one vector per sweep job straight to the MD5 of its frames.
+struct test_vector_sweep
+{
+    std::string *str_arr;
+    std::string *txt_arr;
+    std::string *md5_arr;
+    int threads;
+};
+
+static int test_vector_sweep_job(void *arg, int job)
+{
+    test_vector_sweep *sweep = (test_vector_sweep *)arg;
+    int cur_test_vector = job + 1;
+    char md5[33] = "";
+
+    tprintf(PRINT_STD, "\n\nComputing MD5 for Test Vector %i",
+        cur_test_vector);
+    tprintf(PRINT_ERR, "\n\nComputing MD5 for Test Vector %i\n",
+        cur_test_vector);
+
+    int res = vpxt_dec_md5(sweep->str_arr[cur_test_vector].c_str(),
+        sweep->threads, md5);
+
+    if (res)
+        return res;
+
+    tprintf(PRINT_STD, "\n");
+    tprintf(PRINT_BTH, "%s\n", md5);
+    sweep->md5_arr[cur_test_vector] = md5;
+
+    // kept as the record of what was observed
+    FILE *outfile = fopen(sweep->txt_arr[cur_test_vector].c_str(), "w");
+
+    if (outfile)
+    {
+        fprintf(outfile, "%s", md5);
+        fclose(outfile);
+    }
+
+    return 0;
+}
+
 int test_test_vector(int argc,
                      const char** argv,
                      const std::string &working_dir,
@@ -47,16 +90,6 @@ int test_test_vector(int argc,
         test_vector_num++;
     }
 
-    test_vector_num = 0;
-    std::string test_vector_raw_str_arr[max_test_vector];
-
-    while (test_vector_num < max_test_vector)
-    {
-        test_vector_raw_str_arr[test_vector_num] = test_vector_out_folder +
-            slashCharStr();
-        test_vector_num++;
-    }
-
     test_vector_str_arr[1] += "vp80-00-comprehensive-001.ivf";
     test_vector_str_arr[2] += "vp80-00-comprehensive-002.ivf";
     test_vector_str_arr[3] += "vp80-00-comprehensive-003.ivf";
@@ -159,117 +192,16 @@ int test_test_vector(int argc,
     test_vector_str_arr[100] += "vp80-06-cropping-044.ivf";
     test_vector_str_arr[101] += "vp80-06-cropping-045.ivf";
 
-    test_vector_raw_str_arr[1] += "vp80-00-comprehensive-001.raw";
-    test_vector_raw_str_arr[2] += "vp80-00-comprehensive-002.raw";
-    test_vector_raw_str_arr[3] += "vp80-00-comprehensive-003.raw";
-    test_vector_raw_str_arr[4] += "vp80-00-comprehensive-004.raw";
-    test_vector_raw_str_arr[5] += "vp80-00-comprehensive-005.raw";
-    test_vector_raw_str_arr[6] += "vp80-00-comprehensive-006.raw";
-    test_vector_raw_str_arr[7] += "vp80-00-comprehensive-007.raw";
-    test_vector_raw_str_arr[8] += "vp80-00-comprehensive-008.raw";
-    test_vector_raw_str_arr[9] += "vp80-00-comprehensive-009.raw";
-    test_vector_raw_str_arr[10] += "vp80-00-comprehensive-010.raw";
-    test_vector_raw_str_arr[11] += "vp80-00-comprehensive-011.raw";
-    test_vector_raw_str_arr[12] += "vp80-00-comprehensive-012.raw";
-    test_vector_raw_str_arr[13] += "vp80-00-comprehensive-013.raw";
-    test_vector_raw_str_arr[14] += "vp80-00-comprehensive-014.raw";
-    test_vector_raw_str_arr[15] += "vp80-00-comprehensive-015.raw";
-    test_vector_raw_str_arr[16] += "vp80-00-comprehensive-016.raw";
-    test_vector_raw_str_arr[17] += "vp80-00-comprehensive-017.raw";
-    test_vector_raw_str_arr[18] += "vp80-01-intra-1400.raw";
-    test_vector_raw_str_arr[19] += "vp80-01-intra-1411.raw";
-    test_vector_raw_str_arr[20] += "vp80-01-intra-1416.raw";
-    test_vector_raw_str_arr[21] += "vp80-01-intra-1417.raw";
-    test_vector_raw_str_arr[22] += "vp80-02-inter-1402.raw";
-    test_vector_raw_str_arr[23] += "vp80-02-inter-1412.raw";
-    test_vector_raw_str_arr[24] += "vp80-02-inter-1418.raw";
-    test_vector_raw_str_arr[25] += "vp80-02-inter-1424.raw";
-    test_vector_raw_str_arr[26] += "vp80-03-segmentation-1401.raw";
-    test_vector_raw_str_arr[27] += "vp80-03-segmentation-1403.raw";
-    test_vector_raw_str_arr[28] += "vp80-03-segmentation-1407.raw";
-    test_vector_raw_str_arr[29] += "vp80-03-segmentation-1408.raw";
-    test_vector_raw_str_arr[30] += "vp80-03-segmentation-1409.raw";
-    test_vector_raw_str_arr[31] += "vp80-03-segmentation-1410.raw";
-    test_vector_raw_str_arr[32] += "vp80-03-segmentation-1413.raw";
-    test_vector_raw_str_arr[33] += "vp80-03-segmentation-1414.raw";
-    test_vector_raw_str_arr[34] += "vp80-03-segmentation-1415.raw";
-    test_vector_raw_str_arr[35] += "vp80-03-segmentation-1425.raw";
-    test_vector_raw_str_arr[36] += "vp80-03-segmentation-1426.raw";
-    test_vector_raw_str_arr[37] += "vp80-03-segmentation-1427.raw";
-    test_vector_raw_str_arr[38] += "vp80-03-segmentation-1432.raw";
-    test_vector_raw_str_arr[39] += "vp80-03-segmentation-1435.raw";
-    test_vector_raw_str_arr[40] += "vp80-03-segmentation-1436.raw";
-    test_vector_raw_str_arr[41] += "vp80-03-segmentation-1437.raw";
-    test_vector_raw_str_arr[42] += "vp80-03-segmentation-1441.raw";
-    test_vector_raw_str_arr[43] += "vp80-03-segmentation-1442.raw";
-    test_vector_raw_str_arr[44] += "vp80-04-partitions-1404.raw";
-    test_vector_raw_str_arr[45] += "vp80-04-partitions-1405.raw";
-    test_vector_raw_str_arr[46] += "vp80-04-partitions-1406.raw";
-    test_vector_raw_str_arr[47] += "vp80-05-sharpness-1428.raw";
-    test_vector_raw_str_arr[48] += "vp80-05-sharpness-1429.raw";
-    test_vector_raw_str_arr[49] += "vp80-05-sharpness-1430.raw";
-    test_vector_raw_str_arr[50] += "vp80-05-sharpness-1431.raw";
-    test_vector_raw_str_arr[51] += "vp80-05-sharpness-1433.raw";
-    test_vector_raw_str_arr[52] += "vp80-05-sharpness-1434.raw";
-    test_vector_raw_str_arr[53] += "vp80-05-sharpness-1438.raw";
-    test_vector_raw_str_arr[54] += "vp80-05-sharpness-1439.raw";
-    test_vector_raw_str_arr[55] += "vp80-05-sharpness-1440.raw";
-    test_vector_raw_str_arr[56] += "vp80-05-sharpness-1443.raw";
-    test_vector_raw_str_arr[57] += "vp80-06-cropping-001.raw";
-    test_vector_raw_str_arr[58] += "vp80-06-cropping-002.raw";
-    test_vector_raw_str_arr[59] += "vp80-06-cropping-003.raw";
-    test_vector_raw_str_arr[60] += "vp80-06-cropping-004.raw";
-    test_vector_raw_str_arr[61] += "vp80-06-cropping-005.raw";
-    test_vector_raw_str_arr[62] += "vp80-06-cropping-006.raw";
-    test_vector_raw_str_arr[63] += "vp80-06-cropping-007.raw";
-    test_vector_raw_str_arr[64] += "vp80-06-cropping-008.raw";
-    test_vector_raw_str_arr[65] += "vp80-06-cropping-009.raw";
-    test_vector_raw_str_arr[66] += "vp80-06-cropping-010.raw";
-    test_vector_raw_str_arr[67] += "vp80-06-cropping-011.raw";
-    test_vector_raw_str_arr[68] += "vp80-06-cropping-012.raw";
-    test_vector_raw_str_arr[69] += "vp80-06-cropping-013.raw";
-    test_vector_raw_str_arr[70] += "vp80-06-cropping-014.raw";
-    test_vector_raw_str_arr[71] += "vp80-06-cropping-015.raw";
-    test_vector_raw_str_arr[72] += "vp80-06-cropping-016.raw";
-    test_vector_raw_str_arr[73] += "vp80-06-cropping-017.raw";
-    test_vector_raw_str_arr[74] += "vp80-06-cropping-018.raw";
-    test_vector_raw_str_arr[75] += "vp80-06-cropping-019.raw";
-    test_vector_raw_str_arr[76] += "vp80-06-cropping-020.raw";
-    test_vector_raw_str_arr[77] += "vp80-06-cropping-021.raw";
-    test_vector_raw_str_arr[78] += "vp80-06-cropping-022.raw";
-    test_vector_raw_str_arr[79] += "vp80-06-cropping-023.raw";
-    test_vector_raw_str_arr[80] += "vp80-06-cropping-024.raw";
-    test_vector_raw_str_arr[81] += "vp80-06-cropping-025.raw";
-    test_vector_raw_str_arr[82] += "vp80-06-cropping-026.raw";
-    test_vector_raw_str_arr[83] += "vp80-06-cropping-027.raw";
-    test_vector_raw_str_arr[84] += "vp80-06-cropping-028.raw";
-    test_vector_raw_str_arr[85] += "vp80-06-cropping-029.raw";
-    test_vector_raw_str_arr[86] += "vp80-06-cropping-030.raw";
-    test_vector_raw_str_arr[87] += "vp80-06-cropping-031.raw";
-    test_vector_raw_str_arr[88] += "vp80-06-cropping-032.raw";
-    test_vector_raw_str_arr[89] += "vp80-06-cropping-033.raw";
-    test_vector_raw_str_arr[90] += "vp80-06-cropping-034.raw";
-    test_vector_raw_str_arr[91] += "vp80-06-cropping-035.raw";
-    test_vector_raw_str_arr[92] += "vp80-06-cropping-036.raw";
-    test_vector_raw_str_arr[93] += "vp80-06-cropping-037.raw";
-    test_vector_raw_str_arr[94] += "vp80-06-cropping-038.raw";
-    test_vector_raw_str_arr[95] += "vp80-06-cropping-039.raw";
-    test_vector_raw_str_arr[96] += "vp80-06-cropping-040.raw";
-    test_vector_raw_str_arr[97] += "vp80-06-cropping-041.raw";
-    test_vector_raw_str_arr[98] += "vp80-06-cropping-042.raw";
-    test_vector_raw_str_arr[99] += "vp80-06-cropping-043.raw";
-    test_vector_raw_str_arr[100] += "vp80-06-cropping-044.raw";
-    test_vector_raw_str_arr[101] += "vp80-06-cropping-045.raw";
-
-    test_vector_num = 0;
+    test_vector_num = 1;
     std::string test_vector_txt[max_test_vector];
 
     while (test_vector_num < max_test_vector)
     {
-        vpxt_remove_file_extension(
-            test_vector_raw_str_arr[test_vector_num].c_str(),
-            test_vector_txt[test_vector_num]);
-        test_vector_txt[test_vector_num] += "MD5.txt";
+        char test_vect_file_name[255];
+        vpxt_file_name(test_vector_str_arr[test_vector_num].c_str(),
+            test_vect_file_name, 1);
+        test_vector_txt[test_vector_num] = test_vector_out_folder +
+            slashCharStr() + test_vect_file_name + "MD5.txt";
         test_vector_num++;
     }
 
@@ -479,10 +411,6 @@ int test_test_vector(int argc,
     /*vp80-06-cropping-045.raw*/
     md5_key_str_arr[100].assign("8319b0f71a76787f894f2927b7923897");
 
-    int print_key_track = 0;
-    // if = 1 will delete decompressed tesetvectors if 0 will not
-    int del_tv = 0;
-
     ///////////// Open Output File and Print Header ////////////
     std::string text_file_str = cur_test_dir_str + slashCharStr() + test_dir;
     FILE *fp;
@@ -491,34 +419,8 @@ int test_test_vector(int argc,
     vpxt_print_header(argc, argv, main_test_dir_char, cur_test_dir_str,
         test_dir, test_type);
 
-    if (test_type == kTestOnly)
-    {
-        // This test requires no preperation before a Test Only Run
-    }
-    else
-    {
-        cur_test_vector = 1;
-        while (cur_test_vector < max_test_vector)
-        {
-            tprintf(PRINT_BTH, "\n");
-
-            if (vpxt_decompress_to_raw(
-                test_vector_str_arr[cur_test_vector].c_str(),
-                test_vector_raw_str_arr[cur_test_vector].c_str(), threads)
-                == -1)
-            {
-                fclose(fp);
-                record_test_complete(file_index_str, file_index_output_char,
-                    test_type);
-                return kTestIndeterminate;
-            }
-
-            cur_test_vector++;
-        }
-    }
-
-    std::vector<int> fail_vector;
-
+    // Vectors are decoded straight to their MD5, there is nothing to create
+    // ahead of a Test Only Run.
     if (test_type == kCompOnly)
     {
         fclose(fp);
@@ -526,37 +428,32 @@ int test_test_vector(int argc,
         return kTestEncCreated;
     }
 
-    // Compute MD5 CheckSums
-    cur_test_vector = 1;
+    std::vector<int> fail_vector;
+    std::string md5_observed[max_test_vector];
 
-    while (cur_test_vector < max_test_vector)
-    {
-        tprintf(PRINT_STD, "\n\nComputing MD5 for Test Vector %i",
-            cur_test_vector);
-        tprintf(PRINT_ERR, "\n\nComputing MD5 for Test Vector %i\n",
-            cur_test_vector);
-        vpxt_dec_compute_md5(test_vector_str_arr[cur_test_vector].c_str(),
-            test_vector_txt[cur_test_vector].c_str());
-        cur_test_vector++;
-    }
+    test_vector_sweep sweep_arg;
+    sweep_arg.str_arr = test_vector_str_arr;
+    sweep_arg.txt_arr = test_vector_txt;
+    sweep_arg.md5_arr = md5_observed;
+    sweep_arg.threads = threads;
 
-    if (del_tv == 1)
-    {
-        cur_test_vector = 1;
+    int decode_res[max_test_vector - 1];
 
-        while (cur_test_vector < max_test_vector)
-        {
-            if (remove(test_vector_raw_str_arr[cur_test_vector].c_str()) == 0)
-            {
-                /*printf("%s Successfully Deleted\n\n", outputString.c_str());*/
-            }
-            else
-            {
-                tprintf(PRINT_STD, "Error: %s Not Deleted\n\n",
-                    test_vector_raw_str_arr[cur_test_vector].c_str());
-            }
+    VPXT_SWEEP sweep;
+    vpxt_sweep_init(&sweep, 0);
+    vpxt_sweep_run(&sweep, test_vector_sweep_job, &sweep_arg,
+        max_test_vector - 1, decode_res);
+    vpxt_sweep_destroy(&sweep);
 
-            cur_test_vector++;
+    for (cur_test_vector = 1; cur_test_vector < max_test_vector;
+        cur_test_vector++)
+    {
+        if (decode_res[cur_test_vector - 1])
+        {
+            fclose(fp);
+            record_test_complete(file_index_str, file_index_output_char,
+                test_type);
+            return kTestIndeterminate;
         }
     }
 
@@ -567,18 +464,11 @@ int test_test_vector(int argc,
 
     while (cur_test_vector < max_test_vector)
     {
-        char md5_input_file[255];
         char test_vect_file_name[255];
-        snprintf(md5_input_file, 255, "%s",
-            test_vector_txt[cur_test_vector].c_str());
         vpxt_file_name(test_vector_str_arr[cur_test_vector].c_str(),
             test_vect_file_name, 1);
 
-        char buffer[1024];
-        std::fstream infile;
-        infile.open(md5_input_file);
-        infile.getline(buffer, 1024);
-        infile.close();
+        const char *buffer = md5_observed[cur_test_vector].c_str();
 
         tprintf(PRINT_BTH, "\n\n");
 
@@ -657,10 +547,6 @@ int test_test_vector(int argc,
     if(test_state == kTestFailed)
         tprintf(PRINT_BTH, "\n\nFailed\n");
 
-    if (delete_ivf)
-        for (int z = 1; z < max_test_vector; ++z)
-            vpxt_delete_files(1, test_vector_raw_str_arr[z].c_str());
-
     fclose(fp);
     record_test_complete(file_index_str, file_index_output_char, test_type);
     return test_state;
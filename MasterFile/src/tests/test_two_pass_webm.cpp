@@ -0,0 +1,123 @@
+#include "vpxt_test_declarations.h"
+
+int test_two_pass_webm(int argc,
+                       const char** argv,
+                       const std::string &working_dir,
+                       const std::string sub_folder_str,
+                       int test_type,
+                       int delete_ivf,
+                       int artifact_detection)
+{
+    char *comp_out_str = "Two Pass WebM";
+    char *test_dir = "test_two_pass_webm";
+    int input_ver = vpxt_check_arg_input(argv[1], argc);
+
+    if (input_ver < 0)
+        return vpxt_test_help(argv[1], 0);
+
+    std::string input = argv[2];
+    int bitrate = atoi(argv[3]);
+    // both passes of a WebM encode write through the same EBML writer
+    std::string enc_format = "webm";
+
+    int speed = 0;
+
+    //////////// Formatting Test Specific directory ////////////
+    std::string cur_test_dir_str;
+    std::string file_index_str;
+    char main_test_dir_char[255] = "";
+    char file_index_output_char[255] = "";
+
+    if (initialize_test_directory(argc, argv, test_type, working_dir, test_dir,
+        cur_test_dir_str, file_index_str, main_test_dir_char,
+        file_index_output_char, sub_folder_str) == 11)
+        return kTestErrFileMismatch;
+
+    std::string two_pass_out = cur_test_dir_str + slashCharStr() + test_dir +
+        "_compression";
+    vpxt_enc_format_append(two_pass_out, enc_format);
+
+    ///////////// Open Output File and Print Header ////////////
+    std::string text_file_str = cur_test_dir_str + slashCharStr() + test_dir;
+    FILE *fp;
+
+    vpxt_open_output_file(test_type, text_file_str, fp);
+    vpxt_print_header(argc, argv, main_test_dir_char, cur_test_dir_str,
+        test_dir, test_type);
+
+    VP8_CONFIG opt;
+    vpxt_default_parameters(opt);
+
+    /////////////////// Use Custom Settings ///////////////////
+    if(vpxt_use_custom_settings(argv, argc, input_ver, fp, file_index_str,
+        file_index_output_char, test_type, opt, bitrate)
+        == kTestIndeterminate)
+        return kTestIndeterminate;
+
+    int compress_int = opt.allow_df;
+
+    // Run Test only (Runs Test, Sets up test to be run, or skips compresion of
+    // files)
+    if (test_type == kTestOnly)
+    {
+        // This test requires no preperation before a Test Only Run
+    }
+    else
+    {
+        opt.Mode = kTwoPassGoodQuality;
+        opt.target_bandwidth = bitrate;
+
+        if (vpxt_compress(input.c_str(), two_pass_out.c_str(), speed,
+            bitrate, opt, comp_out_str, compress_int, 0, enc_format,
+            kSetConfigOff) == -1)
+        {
+            fclose(fp);
+            record_test_complete(file_index_str, file_index_output_char,
+                test_type);
+            return kTestIndeterminate;
+        }
+    }
+
+    // Create Compression only stop test short.
+    if (test_type == kCompOnly)
+    {
+        fclose(fp);
+        record_test_complete(file_index_str, file_index_output_char, test_type);
+        return kTestEncCreated;
+    }
+
+    char two_pass_file_name[255];
+    vpxt_file_name(two_pass_out.c_str(), two_pass_file_name, 0);
+
+    tprintf(PRINT_BTH, "\n\nResults:\n\n");
+
+    int test_state = kTestPassed;
+
+    // the second pass writes its file with the writer the first pass used,
+    // every frame it leaves has to decode
+    if (vpxt_dec_check(two_pass_out.c_str(), 0) == 0)
+    {
+        vpxt_formated_print(RESPRT, "All frames of %s decode - Passed",
+            two_pass_file_name);
+        tprintf(PRINT_BTH, "\n");
+    }
+    else
+    {
+        vpxt_formated_print(RESPRT, "Not all frames of %s decode - Failed",
+            two_pass_file_name);
+        tprintf(PRINT_BTH, "\n");
+        test_state = kTestFailed;
+    }
+
+    if (test_state == kTestFailed)
+        tprintf(PRINT_BTH, "\nFailed\n");
+    if (test_state == kTestPassed)
+        tprintf(PRINT_BTH, "\nPassed\n");
+
+    if (delete_ivf)
+        vpxt_delete_files(1, two_pass_out.c_str());
+
+    fclose(fp);
+    record_test_complete(file_index_str, file_index_output_char, test_type);
+    return test_state;
+}
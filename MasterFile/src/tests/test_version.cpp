@@ -92,7 +92,7 @@ int test_version(int argc,
     opt.target_bandwidth = bitrate;
 
     double psnr_arr[4];
-    unsigned int dec_cpu_tick[4];
+    uint64_t dec_cpu_tick[4];
 
     // Run Test only (Runs Test, Sets up test to be run, or skips compresion of
     // files)
@@ -152,10 +152,10 @@ int test_version(int argc,
         }
 
         tprintf(PRINT_STD, "\n\n");
-        unsigned int time_1 = vpxt_time_decompress(version_0.c_str(),
+        uint64_t time_1 = vpxt_time_decompress(version_0.c_str(),
             version_0_dec.c_str(), dec_cpu_tick[0], dec_format, 1);
 
-        if (time_1 == -1)
+        if (time_1 == (uint64_t)-1)
         {
             fclose(fp);
             record_test_complete(file_index_str, file_index_output_char,
@@ -164,10 +164,10 @@ int test_version(int argc,
         }
 
         tprintf(PRINT_STD, "\n");
-        unsigned int time_2 = vpxt_time_decompress(version_1.c_str(),
+        uint64_t time_2 = vpxt_time_decompress(version_1.c_str(),
             version_1_dec.c_str(), dec_cpu_tick[1], dec_format, 1);
 
-        if (time_2 == -1)
+        if (time_2 == (uint64_t)-1)
         {
             fclose(fp);
             record_test_complete(file_index_str, file_index_output_char,
@@ -176,10 +176,10 @@ int test_version(int argc,
         }
 
         tprintf(PRINT_STD, "\n");
-        unsigned int time_3 = vpxt_time_decompress(version_2.c_str(),
+        uint64_t time_3 = vpxt_time_decompress(version_2.c_str(),
             version_2_dec.c_str(), dec_cpu_tick[2], dec_format, 1);
 
-        if (time_3 == -1)
+        if (time_3 == (uint64_t)-1)
         {
             fclose(fp);
             record_test_complete(file_index_str, file_index_output_char,
@@ -188,10 +188,10 @@ int test_version(int argc,
         }
 
         tprintf(PRINT_STD, "\n");
-        unsigned int time_4 = vpxt_time_decompress(version_3.c_str(),
+        uint64_t time_4 = vpxt_time_decompress(version_3.c_str(),
             version_3_dec.c_str(), dec_cpu_tick[3], dec_format, 1);
 
-        if (time_4 == -1)
+        if (time_4 == (uint64_t)-1)
         {
             fclose(fp);
             record_test_complete(file_index_str, file_index_output_char,
@@ -235,20 +235,22 @@ int test_version(int argc,
             {
                 if (dec_cpu_tick[i] < dec_cpu_tick[t])
                 {
-                    tprintf(PRINT_BTH, "\nFailed Version %i Decode Tick: %d "
-                        ">= Version %i Decode Tick: %d\n"
+                    tprintf(PRINT_BTH, "\nFailed Version %i Decode Tick: %llu "
+                        ">= Version %i Decode Tick: %llu\n"
                             "Failed Version %i PSNR: %f <= Version %i PSNR: "
-                            "%f\n", i, dec_cpu_tick[i], t, dec_cpu_tick[t], i,
+                            "%f\n", i, (unsigned long long)dec_cpu_tick[i], t,
+                            (unsigned long long)dec_cpu_tick[t], i,
                             psnr_arr[i], t, psnr_arr[t]);
                     time_fail++;
                     psnr_fail++;
                 }
                 else
                 {
-                    tprintf(PRINT_BTH, "\n       Version %i Decode Tick: %d "
-                        ">= Version %i Decode Tick: %d\n"
+                    tprintf(PRINT_BTH, "\n       Version %i Decode Tick: %llu "
+                        ">= Version %i Decode Tick: %llu\n"
                             "Failed Version %i PSNR: %f <= Version %i PSNR: "
-                            "%f\n", i, dec_cpu_tick[i], t, dec_cpu_tick[t], i,
+                            "%f\n", i, (unsigned long long)dec_cpu_tick[i], t,
+                            (unsigned long long)dec_cpu_tick[t], i,
                             psnr_arr[i], t, psnr_arr[t]);
                     psnr_fail++;
                 }
@@ -257,19 +259,21 @@ int test_version(int argc,
             {
                 if (dec_cpu_tick[i] < dec_cpu_tick[t])
                 {
-                    tprintf(PRINT_BTH, "\nFailed Version %i Decode Tick: %d <= "
-                        "Version %i Decode Tick: %d\n"
+                    tprintf(PRINT_BTH, "\nFailed Version %i Decode Tick: %llu "
+                        "<= Version %i Decode Tick: %llu\n"
                             "       Version %i PSNR: %f >= Version %i PSNR: "
-                            "%f\n", i, dec_cpu_tick[i], t, dec_cpu_tick[t], i,
+                            "%f\n", i, (unsigned long long)dec_cpu_tick[i], t,
+                            (unsigned long long)dec_cpu_tick[t], i,
                             psnr_arr[i], t, psnr_arr[t]);
                     time_fail++;
                 }
                 else
                 {
-                    tprintf(PRINT_BTH, "\n       Version %i Decode Tick: %d >= "
-                        "Version %i Decode Tick: %d\n"
+                    tprintf(PRINT_BTH, "\n       Version %i Decode Tick: %llu "
+                        ">= Version %i Decode Tick: %llu\n"
                             "       Version %i PSNR: %f >= Version %i PSNR: "
-                            "%f\n", i, dec_cpu_tick[i], t, dec_cpu_tick[t], i,
+                            "%f\n", i, (unsigned long long)dec_cpu_tick[i], t,
+                            (unsigned long long)dec_cpu_tick[t], i,
                             psnr_arr[i], t, psnr_arr[t]);
                 }
             }
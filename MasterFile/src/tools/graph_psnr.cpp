@@ -1,4 +1,70 @@
 #include "vpxt_test_declarations.h"
+#include "vpxt_sweep.h"
+
+// One bit rate of the graph per sweep job.  The timed encode and decode
+// run on their own, psnr and data rate of other bit rates side by side.
+struct graph_psnr_sweep
+{
+    const char *input;
+    const char *comp_out_str;
+    const char *enc_format;
+    const char *dec_format;
+    const char *out_base;
+    int speed;
+    int artifact_detection;
+    VP8_CONFIG opt;
+    int *TBRArr;
+    double *psnr_arr;
+    double *SSIMArr;
+    double *DataRateArr;
+    unsigned int *EncTimeArr;
+    unsigned int *DecTimeArr;
+};
+
+static int graph_psnr_sweep_job(void *arg, int x)
+{
+    graph_psnr_sweep *sweep = (graph_psnr_sweep *)arg;
+    VP8_CONFIG opt = sweep->opt;
+    opt.target_bandwidth = sweep->TBRArr[x];
+
+    std::string OutPutStr2 = sweep->out_base;
+    char TBChar[8];
+    vpxt_itoa_custom(opt.target_bandwidth, TBChar, 10);
+    OutPutStr2 += TBChar;
+    std::string OutPutStr3 = OutPutStr2;
+    OutPutStr3 += "_Dec";
+    vpxt_enc_format_append(OutPutStr2, sweep->enc_format);
+    vpxt_dec_format_append(OutPutStr3, sweep->dec_format);
+
+    char outputChar[255];
+    snprintf(outputChar, 255, "%s", OutPutStr2.c_str());
+
+    char outputChar2[255];
+    snprintf(outputChar2, 255, "%s", OutPutStr3.c_str());
+
+    uint64_t cpu_tick_1 = 0;
+    sweep->EncTimeArr[x] = vpxt_time_compress(sweep->input, outputChar,
+        sweep->speed, opt.target_bandwidth, opt, sweep->comp_out_str, 0, 0,
+        cpu_tick_1, sweep->enc_format);
+
+    if (sweep->EncTimeArr[x] == -1)
+        return -1;
+
+    uint64_t cpu_tick_2 = 0;
+    sweep->DecTimeArr[x] = vpxt_time_decompress(outputChar, outputChar2,
+        cpu_tick_2, sweep->dec_format, 1);
+
+    if (sweep->DecTimeArr[x] == -1)
+        return -1;
+
+    double ssimnumber = 0;
+    sweep->psnr_arr[x] = vpxt_psnr(sweep->input, outputChar, 0, PRINT_BTH, 1,
+        0, 0, 0, &ssimnumber, sweep->artifact_detection);
+    sweep->SSIMArr[x] = ssimnumber;
+    sweep->DataRateArr[x] = vpxt_data_rate(outputChar, 1);
+
+    return 0;
+}
 
 int tool_graph_psnr(int argc,
                     const char** argv,
@@ -132,71 +198,61 @@ int tool_graph_psnr(int argc,
     vpxt_output_settings(ParFileOutChar, opt);
     ///////////////////////////////////////////////
 
+    int TBRArr[100];
     int x = 0;
     int DoONce = 0;
 
-    while (opt.target_bandwidth <= LastBitRate)
+    while (opt.target_bandwidth <= LastBitRate && x < 100)
     {
         if (opt.target_bandwidth == LastBitRate && DoONce == 0)
         {
             DoONce = 1;
         }
 
-        std::string OutPutStr2 = OutPutStr;
-        char TBChar[8];
-        vpxt_itoa_custom(opt.target_bandwidth, TBChar, 10);
-        OutPutStr2 += TBChar;
-        std::string OutPutStr3 = OutPutStr2;
-        OutPutStr3 += "_Dec";
-        vpxt_enc_format_append(OutPutStr2, enc_format);
-        vpxt_dec_format_append(OutPutStr3, dec_format);
-
-        char outputChar[255];
-        snprintf(outputChar, 255, "%s", OutPutStr2.c_str());
-
-        char outputChar2[255];
-        snprintf(outputChar2, 255, "%s", OutPutStr3.c_str());
+        TBRArr[x] = opt.target_bandwidth;
+        x++;
 
-        unsigned int cpu_tick_1 = 0;
-        EncTimeArr[x] = vpxt_time_compress(input.c_str(), outputChar, speed,
-            opt.target_bandwidth, opt, comp_out_str, 0, 0, cpu_tick_1,
-            enc_format);
+        opt.target_bandwidth = opt.target_bandwidth + BitRateStep;
 
-        if (EncTimeArr[x] == -1)
+        if (opt.target_bandwidth > LastBitRate && DoONce == 0)
         {
-            fclose(fp);
-            record_test_complete(MainDirString, File1, test_type);
-            return 2;
+            opt.target_bandwidth = LastBitRate;
+            DoONce = 1;
         }
 
-        unsigned int cpu_tick_2 = 0;
-        DecTimeArr[x] = vpxt_time_decompress(outputChar, outputChar2, cpu_tick_2
-            , dec_format, 1);
+    }
 
-        if (DecTimeArr[x] == -1)
+    graph_psnr_sweep sweep_arg;
+    sweep_arg.input = input.c_str();
+    sweep_arg.comp_out_str = comp_out_str;
+    sweep_arg.enc_format = enc_format.c_str();
+    sweep_arg.dec_format = dec_format.c_str();
+    sweep_arg.out_base = OutPutStr.c_str();
+    sweep_arg.speed = speed;
+    sweep_arg.artifact_detection = artifact_detection;
+    sweep_arg.opt = opt;
+    sweep_arg.TBRArr = TBRArr;
+    sweep_arg.psnr_arr = psnr_arr;
+    sweep_arg.SSIMArr = SSIMArr;
+    sweep_arg.DataRateArr = DataRateArr;
+    sweep_arg.EncTimeArr = EncTimeArr;
+    sweep_arg.DecTimeArr = DecTimeArr;
+
+    int sweep_results[100];
+    VPXT_SWEEP sweep;
+    vpxt_sweep_init(&sweep, 0);
+    vpxt_sweep_run(&sweep, graph_psnr_sweep_job, &sweep_arg, x,
+        sweep_results);
+    vpxt_sweep_destroy(&sweep);
+
+    for (v = 0; v < x; v++)
+    {
+        if (sweep_results[v] == -1)
         {
             fclose(fp);
             record_test_complete(MainDirString, File1, test_type);
             return 2;
         }
-
-        double ssimnumber = 0;
-        psnr_arr[x] = vpxt_psnr(input.c_str(), outputChar, 0, PRINT_BTH, 1,
-            0, 0, 0, &ssimnumber, artifact_detection);
-        SSIMArr[x] = ssimnumber;
-        DataRateArr[x] = vpxt_data_rate(outputChar, 1);
-        x++;
-
-
-
-        opt.target_bandwidth = opt.target_bandwidth + BitRateStep;
-
-        if (opt.target_bandwidth > LastBitRate && DoONce == 0)
-        {
-            opt.target_bandwidth = LastBitRate;
-            DoONce = 1;
-        }
-
     }
 
     int ArrSize = x;
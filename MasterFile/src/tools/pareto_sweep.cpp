@@ -0,0 +1,592 @@
+#include "vpxt_test_declarations.h"
+#include "vpxt_sweep.h"
+#include "vpxt_thread.h"
+#include <algorithm>
+
+// One encoder configuration of the sweep, encoded at every bit rate.
+struct sweep_config
+{
+    int mode;
+    int cpu_used;
+    int threads;
+    int token_partitions;
+    // summed over every bit rate
+    double frames;
+    double time;
+    double bd_rate_psnr;
+    double bd_rate_ssim;
+    int valid;
+    int psnr_frontier;
+    int ssim_frontier;
+};
+
+// One encode of the sweep.
+struct sweep_point
+{
+    int config;
+    int bitrate;
+    std::string output;
+    int failed;
+    int frames;
+    double kbps;
+    double psnr;
+    double ssim;
+    VPXT_BENCH_RESULT time;
+};
+
+struct sweep_state
+{
+    const char *input;
+    std::string enc_format;
+    VP8_CONFIG opt;
+    VPXT_BENCH_CONFIG bench;
+    std::vector<sweep_config> *configs;
+    std::vector<sweep_point> *points;
+    // every lane is a group of lane_width processors only one encode runs on
+    vpxt_mutex_t lock;
+    std::vector<int> free_lanes;
+    int lane_width;
+};
+
+static const char *sweep_mode_name(int mode)
+{
+    if (mode == MODE_REALTIME)
+        return "rt";
+
+    if (mode == MODE_BESTQUALITY)
+        return "best";
+
+    if (mode == MODE_SECONDPASS)
+        return "2pass";
+
+    return "good";
+}
+
+static void sweep_parse_list(const char *input, std::vector<int> &list)
+{
+    std::stringstream stream(input);
+    std::string value;
+
+    while (std::getline(stream, value, ','))
+        if (!value.empty())
+            list.push_back(atoi(value.c_str()));
+}
+
+static int sweep_encode(void *arg, int job)
+{
+    sweep_state *state = (sweep_state *)arg;
+    sweep_point *point = &(*state->points)[job];
+    const sweep_config *config = &(*state->configs)[point->config];
+    VP8_CONFIG opt = state->opt;
+    VPXT_ENCODE_PSNR enc_psnr;
+    VPXT_AFFINITY affinity;
+    int lane;
+
+    vpxt_mutex_lock(&state->lock);
+    lane = state->free_lanes.back();
+    state->free_lanes.pop_back();
+    vpxt_mutex_unlock(&state->lock);
+
+    // the encoder's own threads inherit the lane
+    vpxt_thread_affinity_save(&affinity);
+    vpxt_thread_pin(lane * state->lane_width, state->lane_width);
+
+    opt.Mode = config->mode;
+    opt.cpu_used = config->cpu_used;
+    opt.multi_threaded = config->threads;
+    opt.token_partitions = config->token_partitions;
+    opt.target_bandwidth = point->bitrate;
+
+    vpxt_encode_psnr_init(&enc_psnr, 0, 1, kDontRunArtifactDetection);
+
+    point->failed = vpxt_bench_time_compress(&state->bench, kBenchTime,
+        state->input, point->output.c_str(), 0, point->bitrate, opt,
+        "Pareto Sweep", config->cpu_used, 0, state->enc_format, &enc_psnr,
+        &point->time) == -1;
+
+    if (!point->failed)
+    {
+        point->frames = vpxt_get_number_of_frames(point->output.c_str());
+        point->kbps = vpxt_data_rate(point->output.c_str(), 2);
+        point->psnr = enc_psnr.psnr;
+        point->ssim = enc_psnr.ssim;
+    }
+
+    vpxt_thread_affinity_restore(&affinity);
+
+    vpxt_mutex_lock(&state->lock);
+    state->free_lanes.push_back(lane);
+    vpxt_mutex_unlock(&state->lock);
+
+    return point->failed;
+}
+
+// Least squares polynomial of degree through count points, coefficients
+// lowest order first.  x is shifted by center to keep the fit stable.
+static int sweep_poly_fit(const double *x, const double *y, int count,
+                          double center, int degree, double *coef)
+{
+    double matrix[4][5];
+    int n = degree + 1;
+    int row, col, i;
+
+    memset(matrix, 0, sizeof(matrix));
+
+    for (i = 0; i < count; i++)
+    {
+        double power[7];
+        power[0] = 1;
+
+        for (col = 1; col < 2 * n - 1; col++)
+            power[col] = power[col - 1] * (x[i] - center);
+
+        for (row = 0; row < n; row++)
+        {
+            for (col = 0; col < n; col++)
+                matrix[row][col] += power[row + col];
+
+            matrix[row][n] += y[i] * power[row];
+        }
+    }
+
+    // gaussian elimination with partial pivoting
+    for (col = 0; col < n; col++)
+    {
+        int pivot = col;
+
+        for (row = col + 1; row < n; row++)
+            if (fabs(matrix[row][col]) > fabs(matrix[pivot][col]))
+                pivot = row;
+
+        if (fabs(matrix[pivot][col]) < 1e-12)
+            return -1;
+
+        for (i = 0; i <= n; i++)
+            std::swap(matrix[col][i], matrix[pivot][i]);
+
+        for (row = 0; row < n; row++)
+        {
+            if (row == col)
+                continue;
+
+            double factor = matrix[row][col] / matrix[col][col];
+
+            for (i = col; i <= n; i++)
+                matrix[row][i] -= factor * matrix[col][i];
+        }
+    }
+
+    for (row = 0; row < n; row++)
+        coef[row] = matrix[row][n] / matrix[row][row];
+
+    return 0;
+}
+
+// Integral of the fitted log rate over [low, high] of quality.
+static int sweep_log_rate_integral(const std::vector<double> &quality,
+                                   const std::vector<double> &rate,
+                                   double low, double high, double *integral)
+{
+    std::vector<double> log_rate;
+    double coef[4];
+    double center = 0;
+    int count = (int)quality.size();
+    int degree = count - 1 < 3 ? count - 1 : 3;
+    size_t i;
+
+    for (i = 0; i < quality.size(); i++)
+    {
+        log_rate.push_back(log(rate[i]));
+        center += quality[i] / count;
+    }
+
+    if (degree < 1 || sweep_poly_fit(&quality[0], &log_rate[0], count,
+        center, degree, coef))
+        return -1;
+
+    *integral = 0;
+
+    for (i = 0; i <= (size_t)degree; i++)
+        *integral += coef[i] * (pow(high - center, (double)(i + 1)) -
+            pow(low - center, (double)(i + 1))) / (i + 1);
+
+    return 0;
+}
+
+// Bjontegaard delta rate in percent of test against base: the average
+// bit rate difference at equal quality over the quality range both curves
+// cover.  Negative means test needs fewer bits.
+static int sweep_bd_rate(const std::vector<double> &base_quality,
+                         const std::vector<double> &base_rate,
+                         const std::vector<double> &test_quality,
+                         const std::vector<double> &test_rate,
+                         double *bd_rate)
+{
+    double base_integral;
+    double test_integral;
+
+    if (base_quality.size() < 2 || test_quality.size() < 2)
+        return -1;
+
+    double low = std::max(
+        *std::min_element(base_quality.begin(), base_quality.end()),
+        *std::min_element(test_quality.begin(), test_quality.end()));
+    double high = std::min(
+        *std::max_element(base_quality.begin(), base_quality.end()),
+        *std::max_element(test_quality.begin(), test_quality.end()));
+
+    if (high <= low)
+        return -1;
+
+    if (sweep_log_rate_integral(base_quality, base_rate, low, high,
+        &base_integral) || sweep_log_rate_integral(test_quality, test_rate,
+        low, high, &test_integral))
+        return -1;
+
+    *bd_rate = (exp((test_integral - base_integral) / (high - low)) - 1) * 100;
+
+    return 0;
+}
+
+// Rate and quality curve of a configuration.  Ssim is used in decibels so
+// it is spread out like psnr near 1.
+static void sweep_curve(const std::vector<sweep_point> &points, int config,
+                        int use_ssim, std::vector<double> &quality,
+                        std::vector<double> &rate)
+{
+    size_t i;
+
+    for (i = 0; i < points.size(); i++)
+    {
+        const sweep_point &point = points[i];
+
+        if (point.config != config || point.failed || point.kbps <= 0)
+            continue;
+
+        if (use_ssim)
+            quality.push_back(point.ssim < 1 ?
+                -10 * log10(1 - point.ssim) : 100);
+        else
+            quality.push_back(point.psnr);
+
+        rate.push_back(point.kbps);
+    }
+}
+
+// Marks the configurations no other one beats on both speed and bd rate.
+static void sweep_frontier(std::vector<sweep_config> &configs, int use_ssim)
+{
+    size_t i, j;
+
+    for (i = 0; i < configs.size(); i++)
+    {
+        double fps_i = configs[i].frames * 1000000 / configs[i].time;
+        double bd_i = use_ssim ? configs[i].bd_rate_ssim :
+            configs[i].bd_rate_psnr;
+        int dominated = !configs[i].valid;
+
+        for (j = 0; j < configs.size() && !dominated; j++)
+        {
+            if (i == j || !configs[j].valid)
+                continue;
+
+            double fps_j = configs[j].frames * 1000000 / configs[j].time;
+            double bd_j = use_ssim ? configs[j].bd_rate_ssim :
+                configs[j].bd_rate_psnr;
+
+            if (fps_j >= fps_i && bd_j <= bd_i && (fps_j > fps_i ||
+                bd_j < bd_i))
+                dominated = 1;
+        }
+
+        if (use_ssim)
+            configs[i].ssim_frontier = !dominated;
+        else
+            configs[i].psnr_frontier = !dominated;
+    }
+}
+
+int tool_pareto_sweep(int argc, const char** argv)
+{
+    if (argc < 5)
+    {
+        tprintf(PRINT_STD,
+                "\n  Pareto Sweep\n\n"
+                "    <Input File>\n"
+                "    <Output Dir>\n"
+                "    <Bit Rates e.g. 200,400,800,1600>\n"
+                "    <Optional - Modes e.g. good,rt,best,2pass>\n"
+                "    <Optional - Cpu Used e.g. 0,2,4>\n"
+                "    <Optional - Threads e.g. 1,2,4>\n"
+                "    <Optional - Token Partitions e.g. 0,2>\n"
+                "    <Optional - Encode Format - webm/ivf>\n"
+                "    <Optional - Par Input>\n"
+                "\n"
+                "  Every combination is encoded at every bit rate.  The first\n"
+                "  combination is the reference for bd rate.  Repetitions of\n"
+                "  each encode are set by VPXT_BENCH_REPETITIONS.\n"
+                "\n");
+        return 0;
+    }
+
+    std::string input = argv[2];
+    std::string output_dir = argv[3];
+    std::vector<int> bitrates;
+    std::vector<int> modes;
+    std::vector<int> cpu_list;
+    std::vector<int> thread_list;
+    std::vector<int> partition_list;
+    std::vector<sweep_config> configs;
+    std::vector<sweep_point> points;
+    sweep_state state;
+    size_t m, c, t, p, b, i;
+
+    sweep_parse_list(argv[4], bitrates);
+
+    if (argc > 5)
+    {
+        std::stringstream stream(argv[5]);
+        std::string mode;
+
+        while (std::getline(stream, mode, ','))
+        {
+            vpxt_lower_case_string(mode);
+
+            if (mode.compare("rt") == 0)
+                modes.push_back(MODE_REALTIME);
+            else if (mode.compare("best") == 0)
+                modes.push_back(MODE_BESTQUALITY);
+            else if (mode.compare("2pass") == 0)
+                modes.push_back(MODE_SECONDPASS);
+            else if (mode.compare("good") == 0)
+                modes.push_back(MODE_GOODQUALITY);
+        }
+    }
+
+    if (argc > 6)
+        sweep_parse_list(argv[6], cpu_list);
+
+    if (argc > 7)
+        sweep_parse_list(argv[7], thread_list);
+
+    if (argc > 8)
+        sweep_parse_list(argv[8], partition_list);
+
+    state.enc_format = argc > 9 ? argv[9] : "ivf";
+    vpxt_default_parameters(state.opt);
+
+    if (argc > 10)
+        state.opt = vpxt_input_settings(argv[10]);
+
+    if (bitrates.empty())
+    {
+        tprintf(PRINT_STD, "\nNo bit rates given\n");
+        return -1;
+    }
+
+    if (modes.empty())
+        modes.push_back(MODE_GOODQUALITY);
+
+    if (thread_list.empty())
+        thread_list.push_back(0);
+
+    if (partition_list.empty())
+        partition_list.push_back(0);
+
+    std::sort(bitrates.begin(), bitrates.end());
+    bitrates.erase(std::unique(bitrates.begin(), bitrates.end()),
+        bitrates.end());
+
+    for (m = 0; m < modes.size(); m++)
+    {
+        std::vector<int> cpu_used = cpu_list;
+
+        // the same cpu_used ranges test_speed walks
+        if (cpu_used.empty())
+        {
+            int first = modes[m] == MODE_REALTIME ? -1 : 0;
+            int last = modes[m] == MODE_REALTIME ? -16 : 5;
+            int step = modes[m] == MODE_REALTIME ? -3 : 1;
+
+            for (int cpu = first; step > 0 ? cpu <= last : cpu >= last;
+                cpu += step)
+                cpu_used.push_back(cpu);
+        }
+
+        for (c = 0; c < cpu_used.size(); c++)
+            for (t = 0; t < thread_list.size(); t++)
+                for (p = 0; p < partition_list.size(); p++)
+                {
+                    sweep_config config;
+                    memset(&config, 0, sizeof(config));
+                    config.mode = modes[m];
+                    config.cpu_used = cpu_used[c];
+                    config.threads = thread_list[t];
+                    config.token_partitions = partition_list[p];
+                    configs.push_back(config);
+                }
+    }
+
+    char input_name[256];
+    vpxt_file_name(input.c_str(), input_name, 1);
+    vpxt_make_dir(output_dir);
+
+    for (i = 0; i < configs.size(); i++)
+    {
+        for (b = 0; b < bitrates.size(); b++)
+        {
+            char name[512];
+            snprintf(name, sizeof(name), "%s%s%s_%s_cpu%i_t%i_p%i_%i",
+                output_dir.c_str(), slashCharStr().c_str(), input_name,
+                sweep_mode_name(configs[i].mode), configs[i].cpu_used,
+                configs[i].threads, configs[i].token_partitions, bitrates[b]);
+
+            sweep_point point;
+            point.config = (int)i;
+            point.bitrate = bitrates[b];
+            point.output = name;
+            vpxt_enc_format_append(point.output, state.enc_format);
+            point.failed = 1;
+            point.frames = 0;
+            point.kbps = 0;
+            point.psnr = 0;
+            point.ssim = 0;
+            vpxt_bench_clear(&point.time);
+            points.push_back(point);
+        }
+    }
+
+    // encodes run side by side, each on its own group of processors so
+    // they do not compete for the same cores
+    state.lane_width = *std::max_element(thread_list.begin(),
+        thread_list.end());
+
+    if (state.lane_width < 1)
+        state.lane_width = 1;
+
+    int lanes = vpxt_cpu_count() / state.lane_width;
+
+    if (lanes < 1)
+        lanes = 1;
+
+    for (i = lanes; i > 0; i--)
+        state.free_lanes.push_back((int)i - 1);
+
+    state.input = input.c_str();
+    state.configs = &configs;
+    state.points = &points;
+    vpxt_bench_config_init(&state.bench);
+    state.bench.cpu = -1;
+    vpxt_mutex_init(&state.lock);
+
+    tprintf(PRINT_STD, "\nPareto Sweep: %i configurations, %i bit rates, "
+        "%i encodes at a time\n", (int)configs.size(), (int)bitrates.size(),
+        lanes);
+
+    // the sweep replays each encode's output in order and keeps the timed
+    // part of every encode apart from the others
+    VPXT_SWEEP sweep;
+    vpxt_sweep_init(&sweep, lanes);
+    vpxt_sweep_run(&sweep, sweep_encode, &state, (int)points.size(), NULL);
+    vpxt_sweep_destroy(&sweep);
+    vpxt_mutex_destroy(&state.lock);
+
+    // bd rate of every configuration against the first one
+    std::vector<double> base_psnr, base_ssim, base_psnr_rate, base_ssim_rate;
+    sweep_curve(points, 0, 0, base_psnr, base_psnr_rate);
+    sweep_curve(points, 0, 1, base_ssim, base_ssim_rate);
+
+    for (i = 0; i < configs.size(); i++)
+    {
+        std::vector<double> psnr, ssim, psnr_rate, ssim_rate;
+        sweep_config &config = configs[i];
+
+        for (b = 0; b < points.size(); b++)
+        {
+            if (points[b].config != (int)i || points[b].failed)
+                continue;
+
+            config.frames += points[b].frames;
+            config.time += points[b].time.median;
+        }
+
+        sweep_curve(points, (int)i, 0, psnr, psnr_rate);
+        sweep_curve(points, (int)i, 1, ssim, ssim_rate);
+
+        config.valid = config.time > 0 && psnr.size() == bitrates.size() &&
+            !sweep_bd_rate(base_psnr, base_psnr_rate, psnr, psnr_rate,
+            &config.bd_rate_psnr) &&
+            !sweep_bd_rate(base_ssim, base_ssim_rate, ssim, ssim_rate,
+            &config.bd_rate_ssim);
+    }
+
+    sweep_frontier(configs, 0);
+    sweep_frontier(configs, 1);
+
+    std::string json_name = output_dir + slashCharStr() + input_name +
+        "_pareto.json";
+    FILE *json = fopen(json_name.c_str(), "w");
+
+    if (!json)
+    {
+        tprintf(PRINT_STD, "\nCould not open output: %s\n", json_name.c_str());
+        return -1;
+    }
+
+    fprintf(json, "{\"input\": \"%s\",\n\"points\": [\n", input_name);
+
+    for (i = 0; i < points.size(); i++)
+    {
+        const sweep_point &point = points[i];
+        const sweep_config &config = configs[point.config];
+
+        fprintf(json, "{\"mode\": \"%s\", \"cpu_used\": %i, \"threads\": %i, "
+            "\"token_partitions\": %i, \"bitrate\": %i, \"failed\": %i, "
+            "\"frames\": %i, \"kbps\": %.2f, \"psnr\": %.4f, "
+            "\"ssim\": %.6f, \"time_us\": %.0f, \"time_low_us\": %.0f, "
+            "\"time_high_us\": %.0f}%s\n", sweep_mode_name(config.mode),
+            config.cpu_used, config.threads, config.token_partitions,
+            point.bitrate, point.failed, point.frames, point.kbps, point.psnr,
+            point.ssim, point.time.median, point.time.low, point.time.high,
+            i + 1 < points.size() ? "," : "");
+    }
+
+    fprintf(json, "],\n\"configs\": [\n");
+
+    tprintf(PRINT_STD, "\n%-6s %4s %3s %3s %9s %10s %10s  %s\n", "Mode",
+        "Cpu", "Thr", "Tok", "Frames/s", "BD PSNR %", "BD SSIM %",
+        "Frontier");
+
+    for (i = 0; i < configs.size(); i++)
+    {
+        const sweep_config &config = configs[i];
+        double fps = config.time > 0 ?
+            config.frames * 1000000 / config.time : 0;
+        const char *frontier = !config.valid ? "Failed" :
+            config.psnr_frontier && config.ssim_frontier ? "PSNR SSIM" :
+            config.psnr_frontier ? "PSNR" : config.ssim_frontier ? "SSIM" : "";
+
+        tprintf(PRINT_STD, "%-6s %4i %3i %3i %9.1f %10.2f %10.2f  %s\n",
+            sweep_mode_name(config.mode), config.cpu_used, config.threads,
+            config.token_partitions, fps, config.bd_rate_psnr,
+            config.bd_rate_ssim, frontier);
+
+        fprintf(json, "{\"mode\": \"%s\", \"cpu_used\": %i, \"threads\": %i, "
+            "\"token_partitions\": %i, \"valid\": %i, \"fps\": %.2f, "
+            "\"bd_rate_psnr\": %.3f, \"bd_rate_ssim\": %.3f, "
+            "\"psnr_frontier\": %i, \"ssim_frontier\": %i}%s\n",
+            sweep_mode_name(config.mode), config.cpu_used, config.threads,
+            config.token_partitions, config.valid, fps, config.bd_rate_psnr,
+            config.bd_rate_ssim, config.psnr_frontier, config.ssim_frontier,
+            i + 1 < configs.size() ? "," : "");
+    }
+
+    fprintf(json, "]}\n");
+    fclose(json);
+
+    tprintf(PRINT_STD, "\nBD rate is against %s cpu_used %i, written to %s\n\n",
+        sweep_mode_name(configs[0].mode), configs[0].cpu_used,
+        json_name.c_str());
+
+    return 0;
+}
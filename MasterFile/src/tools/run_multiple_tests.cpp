@@ -1,7 +1,402 @@
 #include "vpxt_test_declarations.h"
 #include "vpxt_test_list.h"
 #include "vpxt_driver.h"
+#include "vpxt_scheduler.h"
+#include "vpxt_thread.h"
+#include "vpxt_journal.h"
 
+typedef int (*vpxt_test_fn_t)(int, const char** argv, const std::string &,
+                              const std::string, int, int, int);
+
+// Everything a test needs to run in its own worker.
+struct test_task
+{
+    vpxt_test_fn_t fn;
+    int argc;
+    const char **argv;
+    std::string test_dir;
+    std::string time_stamp;
+    int test_type;
+    int delete_ivf_files;
+    int artifact_detection;
+    // journal the test's encodes are recorded in as test number test_num
+    const char *journal;
+    int test_num;
+};
+
+// A dispatched test waiting for its result to be written to the summary.
+// Results are written in input order so the summary and the lines marked
+// done in tests_run.txt always stay a prefix of the input for resume.
+struct pending_test
+{
+    long line_pos;
+    int done;
+    int result;
+    unsigned int start_time;
+    unsigned int run_time;
+};
+
+static int run_test_task(void *arg)
+{
+    test_task *task = (test_task *)arg;
+    int result;
+
+    vpxt_journal_set_current(task->journal, task->test_num);
+    result = task->fn(task->argc, task->argv, task->test_dir,
+        task->time_stamp, task->test_type, task->delete_ivf_files,
+        task->artifact_detection);
+    vpxt_journal_set_current(NULL, -1);
+
+    return result;
+}
+
+// Journal of a run in the summary folder, test only runs over a folder of
+// compressions keep their own.
+static std::string journal_path(const std::string &folder, int test_type)
+{
+    std::string path = folder;
+
+    if (!path.empty() && path[path.length() - 1] != slashChar())
+        path += slashCharStr();
+
+    if (test_type == kTestOnly)
+        return path + "test_only_journal.jsonl";
+
+    return path + "run_journal.jsonl";
+}
+
+// Tests that time the encoder or decoder, or compare thread counts, run
+// with no other test next to them.
+static int test_runs_exclusive(int selector)
+{
+    return selector == kTestSpeed ||
+        selector == kTestMultiThreadedDec ||
+        selector == kTestMultiThreadedEnc ||
+        selector == kTestChangeCpuDec ||
+        selector == kTestChangeCpuEnc ||
+        selector == kTestNewVsOldEncCpuTick;
+}
+
+// Tests started within the same second share a time stamp and with it an
+// output folder if they are the same test.
+static int time_stamp_in_use(const std::string *selector_arr,
+                             const std::string *selector_arr_2, int count,
+                             const std::string &time_stamp)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+        if (selector_arr[i].compare(selector_arr[count]) == 0 &&
+            selector_arr_2[i].compare(time_stamp) == 0)
+            return 1;
+
+    return 0;
+}
+
+// Ends the program if the run being resumed had already finished.
+static void run_already_complete(int test_running)
+{
+    if (test_running == kFullTest)
+        tprintf(PRINT_STD, "\nAll tests and compressions have already been "
+            "created and run.\n");
+
+    if (test_running == kCompOnly)
+        std::cout << "\nAll compressions have already been created.\n";
+
+    if (test_running == kTestOnly)
+        std::cout << "\nAll tests on compressions have already been run.\n";
+
+    exit(0);
+}
+
+// Reads the results of an interrupted run back from its journal.  Returns
+// the number of tests already run, -1 if the run has no journal.
+static int resume_from_journal(const std::string &folder,
+                               VPXT_JOURNAL *journal,
+                               int number_of_tests,
+                               int *pass_fail_arr,
+                               std::vector<std::string> &selector_arr,
+                               std::vector<std::string> &selector_arr_2,
+                               int &test_running)
+{
+    int tests_run_cnt = 0;
+
+    // a test only run over a folder of compressions is the later run
+    if (vpxt_journal_load(journal_path(folder, kTestOnly).c_str(), journal) ||
+        journal->mode < 0)
+        if (vpxt_journal_load(journal_path(folder, kFullTest).c_str(),
+            journal) || journal->mode < 0)
+            return -1;
+
+    test_running = journal->mode;
+
+    if (journal->done)
+        run_already_complete(test_running);
+
+    // results are journaled in input order, finished tests are a prefix
+    while (tests_run_cnt < (int)journal->tests.size() &&
+        tests_run_cnt < number_of_tests &&
+        journal->tests[tests_run_cnt].result >= 0)
+    {
+        const VPXT_JOURNAL_TEST &test = journal->tests[tests_run_cnt];
+
+        selector_arr[tests_run_cnt] = test.name;
+        selector_arr_2[tests_run_cnt] = test.folder;
+        pass_fail_arr[tests_run_cnt] = test.result;
+        tests_run_cnt++;
+    }
+
+    return tests_run_cnt;
+}
+
+// Reads the results of an interrupted run back from its summary text, for
+// runs started without a journal.  Returns the number of tests already run,
+// -1 if there is no summary.
+static int resume_from_summary(const std::string &summ_comp_and_test,
+                               const std::string &summ_comp,
+                               const std::string &summ_test,
+                               int *pass_fail_arr,
+                               std::vector<std::string> &selector_arr,
+                               std::vector<std::string> &selector_arr_2,
+                               int &test_running)
+{
+    char buffer[1024];
+
+    test_running = kNoTest;
+
+    std::fstream sum_comp_and_test_file;
+    sum_comp_and_test_file.open(summ_comp_and_test.c_str(),
+        std::fstream::in);
+
+    if (sum_comp_and_test_file.good())
+        test_running = kFullTest;
+
+    std::fstream sum_test_file;
+    sum_test_file.open(summ_test.c_str());
+
+    if (sum_test_file.good())
+    {
+        test_running = kTestOnly;
+    }
+
+    std::fstream sum_comp_file;
+    sum_comp_file.open(summ_comp.c_str());
+
+    if (sum_comp_file.good())
+        if (test_running != kTestOnly)
+            test_running = kCompOnly;
+
+    sum_comp_and_test_file.close();
+    sum_test_file.close();
+    sum_comp_file.close();
+
+    // exits with error if it cant find a summary file
+    if (test_running == kNoTest)
+    {
+        tprintf(PRINT_STD, "\nError: No Summary File found\n");
+        return -1;
+    }
+
+    /// Sets Correct input file
+    std::string prior_result_in;
+
+    if (test_running == kFullTest)
+        prior_result_in = summ_comp_and_test;
+
+    if (test_running == kCompOnly)
+        prior_result_in =  summ_comp;
+
+    if (test_running == kTestOnly)
+        prior_result_in = summ_test;
+
+    std::fstream prior_result_input_file;
+    prior_result_input_file.open(prior_result_in.c_str());
+
+    int tests_run_cnt = 0;
+    int var_to_input = 0;
+    int header_line = 0;
+
+    // read in and throw away header
+    while (header_line < 7)
+    {
+        prior_result_input_file.getline(buffer, 1024);
+        header_line++;
+    }
+
+    // read in data and parse values
+    while (!prior_result_input_file.eof())
+    {
+        prior_result_input_file.getline(buffer, 1024);
+        std::string bufferStr = buffer;
+        unsigned int u = 0;
+
+        // 0 number not read yet|1 test_type not read yet|2 TestFolder
+        // not read yet|3 Status not read yet
+        while (buffer[u] != '\0' && buffer[u] != '\r' && u
+            <= bufferStr.length())
+        {
+            if (buffer[u] != ' ')
+            {
+                if (var_to_input == 5)
+                    var_to_input = 0;
+
+                if (var_to_input == 3)
+                {
+                    char buffer3[1024];
+
+                    int a = 0;
+
+                    while (buffer[u] != '\0' && buffer[u] != '\r')
+                    {
+                        buffer3[a] = buffer[u];
+                        u++;
+                        a++;
+
+                    }
+
+                    buffer[u] = '\0';
+                    std::string pass_fail_str = buffer3;
+
+                    if (pass_fail_str.compare("Passed") == 0)
+                        pass_fail_arr[tests_run_cnt] = kTestPassed;
+
+                    if (pass_fail_str.compare("Failed") == 0)
+                        pass_fail_arr[tests_run_cnt] = kTestFailed;
+
+                    if (pass_fail_str.compare("Indeterminate") == 0)
+                        pass_fail_arr[tests_run_cnt] = kTestIndeterminate;
+
+                    if (pass_fail_str.compare("SeeComboRunLog") == 0)
+                        pass_fail_arr[tests_run_cnt] = kTestComboLog;
+
+                    if (pass_fail_str.compare("SeePSNRLog") == 0)
+                        pass_fail_arr[tests_run_cnt] = kTestPsnrLog;
+
+                    if (pass_fail_str.compare("RandomTestCompleted") ==
+                        0)
+                        pass_fail_arr[tests_run_cnt] = kTestRandomComplete;
+
+                    if (pass_fail_str.compare("MinTestPassed") == 0)
+                        pass_fail_arr[tests_run_cnt] = kTestMinPassed;
+
+                    if (pass_fail_str.compare("CompressionMade") == 0)
+                        pass_fail_arr[tests_run_cnt] = kTestEncCreated;
+
+                    if (pass_fail_str.compare("ErrorFileMismatch") == 0)
+                        pass_fail_arr[tests_run_cnt] = kTestErrFileMismatch;
+
+                    if (pass_fail_str.compare("TestNotSupported") == 0)
+                        pass_fail_arr[tests_run_cnt] = kTestNotSupported;
+
+                    if (pass_fail_str.compare("Crashed") == 0)
+                        pass_fail_arr[tests_run_cnt] = kTestCrashed;
+
+                    var_to_input = 4;
+                    memset(buffer3, 0, sizeof(buffer3));
+                }
+
+                if (var_to_input == 2)
+                {
+                    char buffer3[1024];
+
+                    int a = 0;
+
+                    while (a < 24)
+                    {
+                        buffer3[a] = buffer[u];
+                        u++;
+                        a++;
+                    }
+
+                    if (buffer[u] == '_')
+                    {
+                        buffer3[a] = buffer[u];
+                        u++;
+                        a++;
+                        buffer3[a] = buffer[u];
+                    }
+
+                    selector_arr_2[tests_run_cnt] = buffer3;
+                    selector_arr_2[tests_run_cnt] += "\"";
+
+                    var_to_input = 3;
+                    memset(buffer3, 0, sizeof(buffer3));
+                }
+
+                if (var_to_input == 1)
+                {
+                    char buffer3[1024];
+
+                    int a = 0;
+
+                    while (buffer[u] != ' ')
+                    {
+                        buffer3[a] = buffer[u];
+                        u++;
+                        a++;
+                    }
+
+                    selector_arr[tests_run_cnt] = buffer3;
+                    var_to_input = 2;
+                    memset(buffer3, 0, sizeof(buffer3));
+                }
+
+                if (var_to_input == 0)
+                {
+                    char buffer3[1024];
+
+                    int a = 0;
+
+                    while (buffer[u] != ' ')
+                    {
+                        buffer3[a] = buffer[u];
+                        u++;
+                        a++;
+                    }
+
+                    var_to_input = 1;
+                    memset(buffer3, 0, sizeof(buffer3));
+                }
+
+                // resets var at end
+                if (var_to_input == 4)
+                {
+                    int a = 0;
+
+                    while (buffer[u] != '\0' && buffer[u] != '\r')
+                    {
+                        u++;
+                        a++;
+                    }
+
+                    var_to_input = 0;
+                }
+            }
+
+            u++;
+        }
+
+        if (buffer[0] != '\0' && buffer[u] != '\r')
+        {
+            // if the first character of a line after the initial input
+            // is read happens to be a dash it signifies the end of
+            // Tests being run and the start of the summary, meaning
+            // that all operations have already been run and the tests
+            // should teminate.
+            if (buffer[0] == '-')
+            {
+                prior_result_input_file.close();
+                run_already_complete(test_running);
+            }
+
+            tests_run_cnt++;
+        }
+
+    }
+
+    prior_result_input_file.close();
+    return tests_run_cnt;
+}
 int run_multiple_tests(int argc,
                        const char** argv,
                        std::string working_dir,
@@ -32,16 +427,20 @@ int run_multiple_tests(int argc,
 
     std::string string_arr[20];
     std::string time_stamp_arr_2[2];
-    std::string selector_arr[999];
-    std::string selector_arr_2[999];
+    std::vector<std::string> selector_arr(number_of_tests + 2);
+    std::vector<std::string> selector_arr_2(number_of_tests + 2);
 
     ////////////////////// Record time it took to run test /////////////////////
     int record_run_times = 0; // If set to one will record run times of tests
-    unsigned int run_time_1 = 0;
     unsigned int run_time_2 = 0;
-    unsigned long run_time_rec_arr[999];
+    std::vector<unsigned long> run_time_rec_arr(number_of_tests + 2);
     ////////////////////////////////////////////////////////////////////////////
 
+    // journal results are recorded in, empty when resuming a run that was
+    // started without one
+    VPXT_JOURNAL resume_journal;
+    std::string journal_file;
+
     int y = 0;
     int buf_1_var = 0;
     int test_run = 0;
@@ -67,8 +466,7 @@ int run_multiple_tests(int argc,
     char working_dir_3[255] = "";
     char *test_dir = "Summary";
 
-    int (*vpxt_test_funct_ptr[MAXTENUM+1])(int, const char** argv,
-        const std::string &, const std::string, int, int, int) = {NULL};
+    vpxt_test_fn_t vpxt_test_funct_ptr[MAXTENUM+1] = {NULL};
     vpxt_test_funct_ptr[kTestAllowDropFrames] = &test_allow_drop_frames;
     vpxt_test_funct_ptr[kTestAllowLag] = &test_allow_lag;
     vpxt_test_funct_ptr[kTestAllowSpatialResampling] = &test_allow_spatial_resampling;
@@ -117,6 +515,8 @@ int run_multiple_tests(int argc,
     vpxt_test_funct_ptr[kTestVersion] = &test_version;
     vpxt_test_funct_ptr[kTestVpxMatchesInt] = &test_vpx_matches_int;
     vpxt_test_funct_ptr[kTestWinLinMacMatch] = &test_win_lin_mac_match;
+    vpxt_test_funct_ptr[kTestDecBenchJson] = &test_dec_bench_json;
+    vpxt_test_funct_ptr[kTestTwoPassWebm] = &test_two_pass_webm;
 
     char* vpxt_test_name_list[MAXTENUM+1]={
         "RunTestsFromFile",
@@ -167,7 +567,9 @@ int run_multiple_tests(int argc,
         "test_undershoot",
         "test_version",
         "test_vpx_matches_int",
-        "test_win_lin_mac_match"};
+        "test_win_lin_mac_match",
+        "test_dec_bench_json",
+        "test_two_pass_webm"};
 
         //////////////////// Sets Stage for Resume Mode //////////////////////
         if (test_type == kResumeTest)
@@ -195,256 +597,26 @@ int run_multiple_tests(int argc,
                 "compression_test_results.txt"; // Mode 3
 
             int test_running = kNoTest;
+            int tests_run_cnt = resume_from_journal(working_dir,
+                &resume_journal, number_of_tests, pass_fail_arr, selector_arr,
+                selector_arr_2, test_running);
 
-            std::fstream sum_comp_and_test_file;
-            sum_comp_and_test_file.open(summ_comp_and_test.c_str(),
-                std::fstream::in);
-
-            if (sum_comp_and_test_file.good())
-                test_running = kFullTest;
-
-            std::fstream sum_test_file;
-            sum_test_file.open(summ_test.c_str());
-
-            if (sum_test_file.good())
+            if (tests_run_cnt >= 0)
             {
-                test_running = kTestOnly;
+                // encodes the interrupted test had finished are reused
+                vpxt_journal_set_resume(&resume_journal);
+                journal_file = journal_path(working_dir, test_running);
             }
+            else
+                tests_run_cnt = resume_from_summary(summ_comp_and_test,
+                    summ_comp, summ_test, pass_fail_arr, selector_arr,
+                    selector_arr_2, test_running);
 
-            std::fstream sum_comp_file;
-            sum_comp_file.open(summ_comp.c_str());
-
-            if (sum_comp_file.good())
-                if (test_running != kTestOnly)
-                    test_running = kCompOnly;
-
-            sum_comp_and_test_file.close();
-            sum_test_file.close();
-            sum_comp_file.close();
-
-            // exits with error if it cant find a summary file
-            if (test_running == kNoTest)
+            if (tests_run_cnt < 0)
             {
-                tprintf(PRINT_STD, "\nError: No Summary File found\n");
                 delete [] pass_fail_arr;
                 return kTestFailed;
             }
-
-            /// Sets Correct input file
-            std::string prior_result_in;
-
-            if (test_running == kFullTest)
-                prior_result_in = summ_comp_and_test;
-
-            if (test_running == kCompOnly)
-                prior_result_in =  summ_comp;
-
-            if (test_running == kTestOnly)
-                prior_result_in = summ_test;
-
-            std::fstream prior_result_input_file;
-            prior_result_input_file.open(prior_result_in.c_str());
-
-            int tests_run_cnt = 0;
-            int var_to_input = 0;
-            int header_line = 0;
-
-            // read in and throw away header
-            while (header_line < 7)
-            {
-                prior_result_input_file.getline(buffer, 1024);
-                header_line++;
-            }
-
-            // read in data and parse values
-            while (!prior_result_input_file.eof())
-            {
-                prior_result_input_file.getline(buffer, 1024);
-                std::string bufferStr = buffer;
-                unsigned int u = 0;
-
-                // 0 number not read yet|1 test_type not read yet|2 TestFolder
-                // not read yet|3 Status not read yet
-                while (buffer[u] != '\0' && buffer[u] != '\r' && u
-                    <= bufferStr.length())
-                {
-                    if (buffer[u] != ' ')
-                    {
-                        if (var_to_input == 5)
-                            var_to_input = 0;
-
-                        if (var_to_input == 3)
-                        {
-                            char buffer3[1024];
-
-                            int a = 0;
-
-                            while (buffer[u] != '\0' && buffer[u] != '\r')
-                            {
-                                buffer3[a] = buffer[u];
-                                u++;
-                                a++;
-
-                            }
-
-                            buffer[u] = '\0';
-                            std::string pass_fail_str = buffer3;
-
-                            if (pass_fail_str.compare("Passed") == 0)
-                                pass_fail_arr[tests_run_cnt] = kTestPassed;
-
-                            if (pass_fail_str.compare("Failed") == 0)
-                                pass_fail_arr[tests_run_cnt] = kTestFailed;
-
-                            if (pass_fail_str.compare("Indeterminate") == 0)
-                                pass_fail_arr[tests_run_cnt] = kTestIndeterminate;
-
-                            if (pass_fail_str.compare("SeeComboRunLog") == 0)
-                                pass_fail_arr[tests_run_cnt] = kTestComboLog;
-
-                            if (pass_fail_str.compare("SeePSNRLog") == 0)
-                                pass_fail_arr[tests_run_cnt] = kTestPsnrLog;
-
-                            if (pass_fail_str.compare("RandomTestCompleted") ==
-                                0)
-                                pass_fail_arr[tests_run_cnt] = kTestRandomComplete;
-
-                            if (pass_fail_str.compare("MinTestPassed") == 0)
-                                pass_fail_arr[tests_run_cnt] = kTestMinPassed;
-
-                            if (pass_fail_str.compare("CompressionMade") == 0)
-                                pass_fail_arr[tests_run_cnt] = kTestEncCreated;
-
-                            if (pass_fail_str.compare("ErrorFileMismatch") == 0)
-                                pass_fail_arr[tests_run_cnt] = kTestErrFileMismatch;
-
-                            if (pass_fail_str.compare("TestNotSupported") == 0)
-                                pass_fail_arr[tests_run_cnt] = kTestNotSupported;
-
-                            var_to_input = 4;
-                            memset(buffer3, 0, sizeof(buffer3));
-                        }
-
-                        if (var_to_input == 2)
-                        {
-                            char buffer3[1024];
-
-                            int a = 0;
-
-                            while (a < 24)
-                            {
-                                buffer3[a] = buffer[u];
-                                u++;
-                                a++;
-                            }
-
-                            if (buffer[u] == '_')
-                            {
-                                buffer3[a] = buffer[u];
-                                u++;
-                                a++;
-                                buffer3[a] = buffer[u];
-                            }
-
-                            selector_arr_2[tests_run_cnt] = buffer3;
-                            selector_arr_2[tests_run_cnt] += "\"";
-
-                            var_to_input = 3;
-                            memset(buffer3, 0, sizeof(buffer3));
-                        }
-
-                        if (var_to_input == 1)
-                        {
-                            char buffer3[1024];
-
-                            int a = 0;
-
-                            while (buffer[u] != ' ')
-                            {
-                                buffer3[a] = buffer[u];
-                                u++;
-                                a++;
-                            }
-
-                            selector_arr[tests_run_cnt] = buffer3;
-                            var_to_input = 2;
-                            memset(buffer3, 0, sizeof(buffer3));
-                        }
-
-                        if (var_to_input == 0)
-                        {
-                            char buffer3[1024];
-
-                            int a = 0;
-
-                            while (buffer[u] != ' ')
-                            {
-                                buffer3[a] = buffer[u];
-                                u++;
-                                a++;
-                            }
-
-                            var_to_input = 1;
-                            memset(buffer3, 0, sizeof(buffer3));
-                        }
-
-                        // resets var at end
-                        if (var_to_input == 4)
-                        {
-                            int a = 0;
-
-                            while (buffer[u] != '\0' && buffer[u] != '\r')
-                            {
-                                u++;
-                                a++;
-                            }
-
-                            var_to_input = 0;
-                        }
-                    }
-
-                    u++;
-                }
-
-                if (buffer[0] != '\0' && buffer[u] != '\r')
-                {
-                    // if the first character of a line after the initial input
-                    // is read happens to be a dash it signifies the end of
-                    // Tests being run and the start of the summary, meaning
-                    // that all operations have already been run and the tests
-                    // should teminate.
-                    if (buffer[0] == '-')
-                    {
-                        if (test_running == kFullTest)
-                        {
-                            tprintf(PRINT_STD, "\nAll tests and compressions "
-                                "have already been created and run.\n");
-                            prior_result_input_file.close();
-                            exit(0);
-                        }
-
-                        if (test_running == kCompOnly)
-                        {
-                            std::cout << "\nAll compressions have already been "
-                                "created.\n";
-                            prior_result_input_file.close();
-                            exit(0);
-                        }
-
-                        if (test_running == kTestOnly)
-                        {
-                            std::cout << "\nAll tests on compressions have "
-                                "already been run.\n";
-                            prior_result_input_file.close();
-                            exit(0);
-                        }
-                    }
-
-                    tests_run_cnt++;
-                }
-
-            }
-
             test_type = test_running;
             selector_arr_int = tests_run_cnt;
             number_of_tests_run = tests_run_cnt;
@@ -455,7 +627,6 @@ int run_multiple_tests(int argc,
             if (test_type == kTestOnly)
                 number_of_tests_run++;
 
-            prior_result_input_file.close();
             working_dir += "\"";
             print_me = 0;
             make_new_test_run = 0;
@@ -670,71 +841,138 @@ int run_multiple_tests(int argc,
         }
 
         ///////////////// Files are actualy processed and run here /////////////
-        while (!working_text_file.eof())
+        // Tests run side by side in worker processes while lines are read,
+        // results are written out in input order as they become available.
+        VPXT_SCHEDULER scheduler;
+        std::vector<pending_test> pending;
+        test_task task;
+        const char *dummy_argv[999];
+        char test_run_cnt_char[4];
+        std::string worker_output_dir;
+        std::string worker_output;
+        int dispatch_int = selector_arr_int;
+        int input_done = 0;
+        int have_test = 0;
+        int selector = 0;
+
+        if (vpxt_sched_init(&scheduler, 0))
         {
-            memset(buffer, 0, sizeof(buffer));
-
-            const char *dummy_argv[999];
-            dummy_argv[0] = argv[0];
-            dummy_arg_var = 1;
-            file_pos_track = working_text_file.tellg();
-            working_text_file.getline(buffer, 1024);
-            file_pos_track_2 = working_text_file.tellg();
-
-            std::string bufferString = buffer;
-
-            // skips over any line starting with a % in the input file to allow
-            // for comenting
-            if (buffer[0] == '%' || buffer[0] == '\0' || buffer[0] == '+' ||
-                buffer[0] == '-' || buffer[0] == '\r')
-                lines_skipped_cnt++;
-            else
-            {
-                buf_1_var = 0;
+            tprintf(PRINT_STD, "\nCould not start test workers\n");
+            delete [] pass_fail_arr;
+            return kTestFailed;
+        }
+
+        // a new run starts its journal next to the summary
+        if (make_new_test_run == 1)
+        {
+            std::string summary_dir;
+            vpxt_folder_name(work_dir_file_str.c_str(), &summary_dir);
+            journal_file = journal_path(summary_dir, test_type);
+            remove(journal_file.c_str());
+            vpxt_journal_write_run(journal_file.c_str(), test_type);
+        }
+
+        // with tests running side by side their console output goes to a
+        // file per test next to the summary
+        if (scheduler.workers > 1)
+        {
+            vpxt_folder_name(work_dir_file_str.c_str(), &worker_output_dir);
+            worker_output_dir += "worker_output";
+            vpxt_make_dir(worker_output_dir);
+            worker_output_dir += slashCharStr();
+        }
+
+#if !defined(_WIN32)
+        // tests that sweep jobs on their own threads share the processors
+        // with the other workers
+        if (scheduler.workers > 1 && !getenv("VPXT_SWEEP_THREADS"))
+        {
+            char sweep_threads[16];
+            int threads = vpxt_cpu_count() / scheduler.workers;
+
+            snprintf(sweep_threads, sizeof(sweep_threads), "%d",
+                threads > 1 ? threads : 1);
+            setenv("VPXT_SWEEP_THREADS", sweep_threads, 1);
+        }
+#endif
 
-                // parses through gotline and seperates commands out
-                while (buffer[buf_1_var] != '\0' && buffer[buf_1_var] != '\r')
+        while (!input_done || have_test || vpxt_sched_running(&scheduler))
+        {
+            if (!input_done && !have_test)
+            {
+                memset(buffer, 0, sizeof(buffer));
+
+                dummy_argv[0] = argv[0];
+                dummy_arg_var = 1;
+                file_pos_track = working_text_file.tellg();
+                working_text_file.getline(buffer, 1024);
+                file_pos_track_2 = working_text_file.tellg();
+                input_done = !working_text_file.good();
+
+                std::string bufferString = buffer;
+
+                // skips over any line starting with a % in the input file to
+                // allow for comenting
+                if (buffer[0] == '%' || buffer[0] == '\0' ||
+                    buffer[0] == '+' || buffer[0] == '-' || buffer[0] == '\r')
+                    lines_skipped_cnt++;
+                else
                 {
-                    int buf_2_var = 0;
+                    buf_1_var = 0;
 
-                    while (buffer[buf_1_var] != 64 && buffer[buf_1_var] != '\0'
-                        && buffer[buf_1_var] != '\r')
+                    // parses through gotline and seperates commands out
+                    while (buffer[buf_1_var] != '\0' &&
+                        buffer[buf_1_var] != '\r')
                     {
-                        buffer2[buf_2_var] = buffer[buf_1_var];
-                        buf_1_var++;
-                        buf_2_var++;
+                        int buf_2_var = 0;
+
+                        while (buffer[buf_1_var] != 64 &&
+                            buffer[buf_1_var] != '\0' &&
+                            buffer[buf_1_var] != '\r')
+                        {
+                            buffer2[buf_2_var] = buffer[buf_1_var];
+                            buf_1_var++;
+                            buf_2_var++;
+                        }
+
+                        buffer2[buf_2_var] = '\0';
+
+                        if (buffer[buf_1_var] != '\0' &&
+                            buffer[buf_1_var] != '\r')
+                        {
+                            buf_1_var++;
+                        }
+
+                        string_arr[dummy_arg_var] = buffer2;
+                        dummy_arg_var++;
                     }
 
-                    buffer2[buf_2_var] = '\0';
+                    y = 1;
 
-                    if (buffer[buf_1_var] != '\0' && buffer[buf_1_var] != '\r')
+                    while (y < dummy_arg_var)
                     {
-                        buf_1_var++;
+                        dummy_argv[y] = string_arr[y].c_str();
+                        y++;
                     }
 
-                    string_arr[dummy_arg_var] = buffer2;
-                    dummy_arg_var++;
-                }
+                    dummy_argv[y] = vpxt_itoa_custom(number_of_tests_run,
+                        test_run_cnt_char, 10);
 
-                y = 1;
+                    tprintf(PRINT_STD, "\n");
 
-                while (y < dummy_arg_var)
-                {
-                    dummy_argv[y] = string_arr[y].c_str();
-                    y++;
-                }
+                    selector = vpxt_identify_test(dummy_argv[1]);
 
-                char test_run_cnt_char[4];
-                dummy_argv[y] = vpxt_itoa_custom(number_of_tests_run,
-                    test_run_cnt_char, 10);
+                    if (selector >= 0 && selector <= MAXTENUM)
+                        number_of_tests_run++;
 
-                tprintf(PRINT_STD, "\n");
-
-                int selector = vpxt_identify_test(dummy_argv[1]);
+                    have_test = 1;
+                }
+            }
 
-                if (selector >= 0 && selector < MAXTENUM)
-                    number_of_tests_run++;
+            int exclusive = have_test && test_runs_exclusive(selector);
 
+            if (have_test && vpxt_sched_can_start(&scheduler, exclusive))
+            {
                 prev_time_stamp = time_stamp_arr_2[0];
                 time_stamp_arr_2[0] = date_string();
 
@@ -748,24 +986,102 @@ int run_multiple_tests(int argc,
                     if (test_type == kFullTest)
                         tprintf(PRINT_STD, "Not Implemented Yet.\n");
 
-                selector_arr[selector_arr_int] = vpxt_test_name_list[selector];
-                check_time_stamp(selector_arr_int, selector_arr, selector_arr_2,
-                    prev_time_stamp, identical_file_cnt, time_stamp_arr_2);
-                selector_arr_2[selector_arr_int] = time_stamp_arr_2[0];
+                selector_arr[dispatch_int] = vpxt_test_name_list[selector];
+                check_time_stamp(dispatch_int, &selector_arr[0],
+                    &selector_arr_2[0], prev_time_stamp, identical_file_cnt,
+                    time_stamp_arr_2);
 
-                if (record_run_times == 1)
-                    run_time_1 = vpxt_get_time();
+                while (time_stamp_in_use(&selector_arr[0], &selector_arr_2[0],
+                    dispatch_int, time_stamp_arr_2[0]))
+                {
+                    char identical_file_buffer[8];
+                    identical_file_cnt++;
+                    vpxt_itoa_custom(identical_file_cnt, identical_file_buffer,
+                        10);
+                    time_stamp_arr_2[0] = date_string();
+                    time_stamp_arr_2[0].erase(time_stamp_arr_2[0].end() - 1);
+                    time_stamp_arr_2[0] += "_";
+                    time_stamp_arr_2[0] += identical_file_buffer;
+                    time_stamp_arr_2[0] += "\"";
+                }
+
+                selector_arr_2[dispatch_int] = time_stamp_arr_2[0];
+
+                if (!journal_file.empty())
+                    vpxt_journal_write_start(journal_file.c_str(),
+                        dispatch_int, selector_arr[dispatch_int],
+                        selector_arr_2[dispatch_int]);
+
+                pending_test test;
+                test.line_pos = file_pos_track;
+                test.done = 0;
+                test.result = kTestFailed;
+                test.start_time = vpxt_get_time();
+                test.run_time = 0;
+                pending.push_back(test);
+
+                task.fn = vpxt_test_funct_ptr[selector];
+                task.argc = dummy_arg_var;
+                task.argv = dummy_argv;
+                task.test_dir = TestDir;
+                task.time_stamp = time_stamp_arr_2[0];
+                task.test_type = test_type;
+                task.delete_ivf_files = delete_ivf_files;
+                task.artifact_detection = artifact_detection;
+                task.journal = journal_file.empty() ? NULL :
+                    journal_file.c_str();
+                task.test_num = dispatch_int;
+
+                if (scheduler.workers > 1)
+                {
+                    char dispatch_char[8];
+                    worker_output = worker_output_dir +
+                        vpxt_itoa_custom(dispatch_int, dispatch_char, 10) +
+                        "_" + selector_arr[dispatch_int] + ".txt";
+                }
+
+                vpxt_sched_start(&scheduler, dispatch_int, exclusive,
+                    scheduler.workers > 1 ? worker_output.c_str() : NULL,
+                    run_test_task, &task);
+                dispatch_int++;
+                have_test = 0;
+            }
+            else if ((have_test || input_done) &&
+                vpxt_sched_running(&scheduler))
+            {
+                int job;
+                int result;
 
-                pass_fail_arr[pass_fail_int] = vpxt_test_funct_ptr[selector]
-                (dummy_arg_var, (const char **)dummy_argv, TestDir,
-                    time_stamp_arr_2[0], test_type, delete_ivf_files,
-                    artifact_detection);
+                if (vpxt_sched_wait(&scheduler, &job, &result) == 0)
+                {
+                    pending_test &test = pending[job - selector_arr_int];
+                    const char *crash = vpxt_sched_result_name(result);
+
+                    if (crash)
+                    {
+                        tprintf(PRINT_STD, "\n%s: %s\n",
+                            selector_arr[job].c_str(), crash);
+                        result = kTestCrashed;
+                    }
 
-                if (record_run_times == 1){
+                    test.result = result;
+                    test.done = 1;
                     run_time_2 = vpxt_get_time();
-                    run_time_rec_arr[selector_arr_int] =
-                        vpxt_get_time_in_micro_sec(run_time_1, run_time_2);
+                    test.run_time = vpxt_get_time_in_micro_sec(test.start_time,
+                        run_time_2);
                 }
+            }
+
+            while (!pending.empty() && pending[0].done)
+            {
+                pass_fail_arr[pass_fail_int] = pending[0].result;
+
+                if (!journal_file.empty())
+                    vpxt_journal_write_end(journal_file.c_str(),
+                        selector_arr_int, pending[0].result);
+
+                if (record_run_times == 1)
+                    run_time_rec_arr[selector_arr_int] = pending[0].run_time;
 
                 test_run++;
 
@@ -974,6 +1290,16 @@ int run_multiple_tests(int argc,
                     tprintf(PRINT_ERR, "TestNotSupported\n");
                     fprintf(fp_html, "TestNotSupported\n");
                 }
+
+                if (pass_fail_arr[selector_arr_int] == kTestCrashed)
+                {
+                    tprintf(PRINT_ERR, "Crashed\n");
+
+                    html_status += ".txt\" color=\"red\">";
+                    html_status += "Crashed";
+                    html_status += "</a>";
+                    fprintf(fp_html, "%s \n", html_status.c_str());
+                }
                 if (pass_fail_arr[selector_arr_int] == kTestPossibleArtifact)
                 {
                     tprintf(PRINT_ERR, "PossibleArtifact\n");
@@ -987,9 +1313,11 @@ int run_multiple_tests(int argc,
                 fclose(fp);
                 fclose(fp_html);
 
-                working_text_file.seekg(file_pos_track);
-                std::string bufferstring = buffer;
-                bufferstring.erase(0);
+                // marks the line done, the read position is put back after
+                working_text_file.clear();
+                file_pos_track_2 = working_text_file.tellg();
+                working_text_file.seekg(pending[0].line_pos);
+                std::string bufferstring;
 
                 if (test_type == kTestOnly)
                     bufferstring.insert(0, "-");
@@ -1000,12 +1328,17 @@ int run_multiple_tests(int argc,
                 working_text_file.seekg(file_pos_track_2);
                 ////////////////////////////////////////////////////////////////
 
+                pending.erase(pending.begin());
                 pass_fail_int++;
                 selector_arr_int++;
             }
         }
 
+        vpxt_sched_destroy(&scheduler);
         working_text_file.close();
+
+        if (!journal_file.empty() && test_run != tests_run_catch)
+            vpxt_journal_write_done(journal_file.c_str());
         // outputs a summary of the test results
 
         if (test_run == 0)
@@ -1502,6 +1835,12 @@ int run_multiple_tests(int argc,
                         fprintf(fp_html, "TestNotSupported\n");
                     }
 
+                    if (pass_fail_arr[y] == kTestCrashed)
+                    {
+                        tprintf(PRINT_BTH, "Crashed\n");
+                        fprintf(fp_html, "Crashed\n");
+                    }
+
                     if (pass_fail_arr[y] == kTestPossibleArtifact)
                     {
                         tprintf(PRINT_BTH, "PossibleArtifact\n");
@@ -1725,6 +2064,16 @@ int run_multiple_tests(int argc,
                 fprintf(fp_html, "TestNotSupported\n");
             }
 
+            if (pass_fail_arr[y] == kTestCrashed)
+            {
+                tprintf(PRINT_BTH, "Crashed\n");
+
+                html_status += ".txt\" color=\"red\">";
+                html_status += "Crashed";
+                html_status += "</a>";
+                fprintf(fp_html, "%s \n", html_status.c_str());
+            }
+
             if (pass_fail_arr[y] == kTestPossibleArtifact)
             {
                 tprintf(PRINT_BTH, "PossibleArtifact\n");
@@ -5,12 +5,16 @@
 #include "comp_ivf.h"
 #include "onyx.h"
 #include "ivf.h"
+#include "vpxt_psnr.h"
+#include "vpxt_json.h"
 #include <sstream>
 #include <fstream>
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <cmath>
 #include <vector>
+#include <algorithm>
 #if defined(ARM)
 #include "arm.h"
 #else
@@ -830,7 +834,7 @@ int tool_vpxt_enc(int argc, const char** argv, std::string working_dir)
 
     if (compression_type == 2)
     {
-        unsigned int CPUTick = 0;
+        uint64_t CPUTick = 0;
         vpxt_time_compress(input.c_str(), output.c_str(), speed, bitrate,
             opt, comp_out_str, compress_int, 0, CPUTick, enc_format);
     }
@@ -2035,6 +2039,386 @@ int tool_print_cpu_info()
 
     return 0;
 }
+int tool_psnr_kernel_bench(int argc, const char** argv)
+{
+    // times every sse and ssim kernel the cpu supports on a pair of 1080p
+    // planes
+    const int width = 1920;
+    const int height = 1080;
+    const int stride = width + 2 * VP8BORDERINPIXELS;
+    int iterations = 200;
+    int kernel_type;
+    int i;
+
+    if (argc > 2)
+        iterations = atoi(argv[2]);
+
+    if (iterations < 1)
+    {
+        tprintf(PRINT_STD, "\n"
+                "  PSNR Kernel Bench\n\n"
+                "    <Optional - Iterations>\n"
+                "\n");
+        return 0;
+    }
+
+    unsigned char *src = new unsigned char[stride * height];
+    unsigned char *dst = new unsigned char[stride * height];
+
+    srand(1);
+
+    for (i = 0; i < stride * height; i++)
+    {
+        src[i] = rand() & 0xff;
+        dst[i] = src[i] + (rand() % 9) - 4;
+    }
+
+    uint64_t reference = vpxt_sse_c(src, stride, dst, stride, width, height);
+    double bytes_per_iteration = 2.0 * width * height;
+
+    tprintf(PRINT_STD, "\nSSE kernels on %i x %i planes, %i iterations:\n\n",
+        width, height, iterations);
+
+    for (kernel_type = 0; kernel_type < kSseKernelCount; kernel_type++)
+    {
+        vpxt_sse_fn_t kernel = vpxt_sse_kernel(kernel_type);
+
+        if (!kernel)
+        {
+            tprintf(PRINT_STD, "     %-5s Not supported\n",
+                vpxt_sse_kernel_name(kernel_type));
+            continue;
+        }
+
+        uint64_t result = 0;
+        unsigned int start = vpxt_get_high_res_timer_tick();
+
+        for (i = 0; i < iterations; i++)
+            result = kernel(src, stride, dst, stride, width, height);
+
+        unsigned int stop = vpxt_get_high_res_timer_tick();
+        unsigned int micro_sec = vpxt_get_time_in_micro_sec(start, stop);
+
+        if (micro_sec == 0)
+            micro_sec = 1;
+
+        tprintf(PRINT_STD, "     %-5s %8.2f GB/s  %10.2f us/plane  %s\n",
+            vpxt_sse_kernel_name(kernel_type),
+            bytes_per_iteration * iterations / micro_sec / 1000.0,
+            (double)micro_sec / iterations,
+            result == reference ? "Match" : "MISMATCH");
+    }
+
+    // ssim on the same planes: scalar, simd and simd split into row bands.
+    // Banded results may differ from the scalar ones in the last bits.
+    const double ssim_tolerance = 1e-12;
+    const char *ssim_mode_names[3] = {"C", "SIMD", "Bands"};
+    int ssim_iterations = iterations / 20 + 1;
+    double ref_ssim = 0;
+    double ref_ssimg = 0;
+    YV12_BUFFER_CONFIG src_yv12;
+    YV12_BUFFER_CONFIG dst_yv12;
+    VPXT_WORKER_POOL pool;
+    int mode;
+
+    memset(&src_yv12, 0, sizeof(src_yv12));
+    src_yv12.y_width = width;
+    src_yv12.y_height = height;
+    src_yv12.y_stride = stride;
+    src_yv12.uv_width = width / 2;
+    src_yv12.uv_height = height / 2;
+    src_yv12.uv_stride = stride;
+    dst_yv12 = src_yv12;
+    src_yv12.y_buffer = src;
+    src_yv12.u_buffer = src + stride * (height / 4);
+    src_yv12.v_buffer = src + stride * (height / 2);
+    dst_yv12.y_buffer = dst;
+    dst_yv12.u_buffer = dst + stride * (height / 4);
+    dst_yv12.v_buffer = dst + stride * (height / 2);
+
+    vpxt_pool_create(&pool, vpxt_cpu_count() - 1);
+
+    tprintf(PRINT_STD, "\nSSIM on %i x %i frames, %i iterations, %i "
+        "threads:\n\n", width, height, ssim_iterations, pool.thread_count + 1);
+
+    for (mode = 0; mode < 3; mode++)
+    {
+        VPXT_SSIM_CTX ssim_ctx;
+        double weight;
+        double ssim = 0;
+        double ssimg = 0;
+        double ssim_y, ssim_u, ssim_v;
+
+        vpxt_ssim_ctx_init(&ssim_ctx);
+
+        if (mode == 0)
+            ssim_ctx.kernel_type = kSseKernelC;
+
+        if (mode == 2)
+            ssim_ctx.pool = &pool;
+
+        unsigned int start = vpxt_get_high_res_timer_tick();
+
+        for (i = 0; i < ssim_iterations; i++)
+            ssim = vpxt_calc_ssim(&ssim_ctx, &src_yv12, &dst_yv12, 1, &weight);
+
+        unsigned int stop = vpxt_get_high_res_timer_tick();
+        unsigned int ssim_us = vpxt_get_time_in_micro_sec(start, stop);
+
+        start = vpxt_get_high_res_timer_tick();
+
+        for (i = 0; i < ssim_iterations; i++)
+            ssimg = vpxt_calc_ssimg(&ssim_ctx, &src_yv12, &dst_yv12, &ssim_y,
+                &ssim_u, &ssim_v);
+
+        stop = vpxt_get_high_res_timer_tick();
+        unsigned int ssimg_us = vpxt_get_time_in_micro_sec(start, stop);
+
+        vpxt_ssim_ctx_free(&ssim_ctx);
+
+        if (mode == 0)
+        {
+            ref_ssim = ssim;
+            ref_ssimg = ssimg;
+        }
+
+        tprintf(PRINT_STD, "     %-5s %8.2f ms ssim  %8.2f ms ssimg  %s\n",
+            ssim_mode_names[mode], ssim_us / 1000.0 / ssim_iterations,
+            ssimg_us / 1000.0 / ssim_iterations,
+            fabs(ssim - ref_ssim) <= ssim_tolerance * fabs(ref_ssim) &&
+            fabs(ssimg - ref_ssimg) <= ssim_tolerance * fabs(ref_ssimg) ?
+            "Match" : "MISMATCH");
+    }
+
+    vpxt_pool_destroy(&pool);
+
+    tprintf(PRINT_STD, "\n");
+
+    delete [] src;
+    delete [] dst;
+
+    return 0;
+}
+static void dec_bench_parse_list(const char *input, std::vector<int> &list)
+{
+    std::stringstream stream(input);
+    std::string value;
+
+    while (std::getline(stream, value, ','))
+        if (!value.empty())
+            list.push_back(atoi(value.c_str()));
+}
+int tool_dec_bench(int argc, const char** argv)
+{
+    // decodes every file from memory with the output thrown away, for each
+    // thread count and post processing level
+    if (argc < 4)
+    {
+        tprintf(PRINT_STD,
+                "\n  Decoder Throughput Bench\n\n"
+                "    <Input File or Folder>\n"
+                "    <Output Json>\n"
+                "    <Optional - Threads e.g. 0,2,4>\n"
+                "    <Optional - Postproc levels e.g. 0,6>\n"
+                "    <Optional - Baseline Json>\n"
+                "    <Optional - Regression Threshold %%, default 5>\n"
+                "\n"
+                "  Repetitions and warm up runs are set by\n"
+                "  VPXT_BENCH_REPETITIONS and VPXT_BENCH_WARMUP.\n"
+                "\n");
+        return 0;
+    }
+
+    std::string input = argv[2];
+    std::vector<std::string> files;
+    std::vector<int> thread_list;
+    std::vector<int> postproc_list;
+    std::vector<std::string> baseline_keys;
+    std::vector<double> baseline_fps;
+    double threshold = 5;
+    int regressions = 0;
+    size_t file_num;
+    size_t i;
+
+    if (vpxt_folder_exist_check(input))
+    {
+        std::vector<std::string> dir_files;
+        vpxt_list_files_in_dir(dir_files, input);
+
+        for (i = 0; i < dir_files.size(); i++)
+        {
+            char file_name[256];
+            vpxt_file_name(dir_files[i].c_str(), file_name, 0);
+            std::string name = file_name;
+            size_t dot = name.find_last_of('.');
+            std::string ext = dot == std::string::npos ? "" :
+                name.substr(dot + 1);
+            vpxt_lower_case_string(ext);
+
+            if (ext.compare("ivf") == 0 || ext.compare("webm") == 0)
+                files.push_back(input + slashCharStr() + name);
+        }
+
+        std::sort(files.begin(), files.end());
+    }
+    else
+        files.push_back(input);
+
+    if (argc > 4)
+        dec_bench_parse_list(argv[4], thread_list);
+
+    if (argc > 5)
+        dec_bench_parse_list(argv[5], postproc_list);
+
+    if (argc > 7)
+        threshold = atof(argv[7]);
+
+    if (thread_list.empty())
+        thread_list.push_back(0);
+
+    if (postproc_list.empty())
+        postproc_list.push_back(0);
+
+    if (argc > 6)
+    {
+        std::ifstream baseline(argv[6]);
+        std::string line;
+
+        if (!baseline.good())
+        {
+            tprintf(PRINT_STD, "\nCould not open baseline: %s\n", argv[6]);
+            return -1;
+        }
+
+        while (std::getline(baseline, line))
+        {
+            std::vector<std::string> names;
+            std::vector<std::string> values;
+
+            if (vpxt_json_parse_record(line, names, values))
+                continue;
+
+            const std::string *file = vpxt_json_field(names, values, "file");
+            const std::string *threads =
+                vpxt_json_field(names, values, "threads");
+            const std::string *postproc =
+                vpxt_json_field(names, values, "postproc");
+            const std::string *fps = vpxt_json_field(names, values, "fps");
+
+            if (!file || !threads || !postproc || !fps)
+                continue;
+
+            baseline_keys.push_back(*file + " " + *threads + " " + *postproc);
+            baseline_fps.push_back(atof(fps->c_str()));
+        }
+    }
+
+    FILE *json = fopen(argv[3], "w");
+
+    if (!json)
+    {
+        tprintf(PRINT_STD, "\nCould not open output: %s\n", argv[3]);
+        return -1;
+    }
+
+    VPXT_BENCH_CONFIG config;
+    vpxt_bench_config_init(&config);
+
+    fprintf(json, "[\n");
+
+    tprintf(PRINT_STD, "\n%-32s %3s %3s %9s %8s %8s %8s  %s\n", "File",
+        "Thr", "PP", "Frames/s", "MB/s", "p50 us", "p99 us", "Baseline");
+
+    int first = 1;
+
+    for (file_num = 0; file_num < files.size(); file_num++)
+    {
+        char file_name[256];
+        vpxt_file_name(files[file_num].c_str(), file_name, 0);
+
+        for (size_t t = 0; t < thread_list.size(); t++)
+        {
+            for (size_t p = 0; p < postproc_list.size(); p++)
+            {
+                VPXT_DEC_BENCH result;
+                int threads = thread_list[t];
+                int postproc = postproc_list[p];
+
+                if (vpxt_dec_bench(&config, files[file_num].c_str(), threads,
+                    postproc, &result))
+                {
+                    tprintf(PRINT_STD, "%-32s Failed\n", file_name);
+                    regressions++;
+                    continue;
+                }
+
+                double time = result.time.median > 0 ? result.time.median : 1;
+                double best = result.time.low > 0 ? result.time.low : time;
+                double fps = result.frames * 1000000.0 / time;
+                double mbps = result.bytes / time;
+                const char *status = "-";
+
+                // only a regression if even the fastest plausible time
+                // misses the baseline
+                char key[300];
+                snprintf(key, sizeof(key), "%s %i %i", file_name, threads,
+                    postproc);
+
+                for (i = 0; i < baseline_keys.size(); i++)
+                {
+                    if (baseline_keys[i].compare(key) != 0)
+                        continue;
+
+                    status = "Passed";
+
+                    if (result.frames * 1000000.0 / best <
+                        baseline_fps[i] * (1 - threshold / 100))
+                    {
+                        status = "Regressed";
+                        regressions++;
+                    }
+                }
+
+                tprintf(PRINT_STD, "%-32s %3i %3i %9.1f %8.2f %8u %8u  %s\n",
+                    file_name, threads, postproc, fps, mbps,
+                    result.latency_p50, result.latency_p99, status);
+
+                std::string json_file;
+                vpxt_json_string(json_file, file_name);
+
+                fprintf(json, "%s{\"file\": %s, \"threads\": %i, "
+                    "\"postproc\": %i, \"width\": %u, \"height\": %u, "
+                    "\"frames\": %i, \"bytes\": %.0f, \"runs\": %i, "
+                    "\"time_us\": %.0f, \"time_low_us\": %.0f, "
+                    "\"time_high_us\": %.0f, \"fps\": %.2f, \"mbps\": %.3f, "
+                    "\"latency_p50_us\": %u, \"latency_p90_us\": %u, "
+                    "\"latency_p99_us\": %u, \"latency_max_us\": %u, "
+                    "\"status\": \"%s\"}", first ? "" : ",\n",
+                    json_file.c_str(), threads, postproc, result.width,
+                    result.height, result.frames, result.bytes,
+                    result.time.count, result.time.median, result.time.low,
+                    result.time.high, fps, mbps, result.latency_p50,
+                    result.latency_p90, result.latency_p99,
+                    result.latency_max, status);
+                first = 0;
+            }
+        }
+    }
+
+    fprintf(json, "\n]\n");
+    fclose(json);
+
+    tprintf(PRINT_STD, "\n");
+
+    if (regressions)
+    {
+        tprintf(PRINT_STD, "%i results regressed more than %.1f%% or failed"
+            "\n\n", regressions, threshold);
+        return 1;
+    }
+
+    return 0;
+}
 int tool_random_stress_test(int argc, const char** argv)
 {
     if (argc < 6)
@@ -3051,6 +3435,23 @@ int tool_random_stress_test(int argc, const char** argv)
         {
         }
 
+        if (valid_test_numbers[rand_test_num] == kTestDecBenchJson)
+        {
+            out_file << "test_dec_bench_json";
+            out_file << "\n";
+        }
+
+        if (valid_test_numbers[rand_test_num] == kTestTwoPassWebm)
+        {
+            out_file << "test_two_pass_webm@";
+            out_file << rand_source_file.c_str();
+            out_file << "@";
+            out_file << rand_tb_num;
+            out_file << "@";
+            out_file << rand_setting_file.c_str();
+            out_file << "\n";
+        }
+
         current_test++;
     }
 
@@ -1,9 +1,301 @@
 #include "yv12config.h"
 #include "vpxt_utilities.h"
+#include "vpxt_psnr.h"
+#include "vpxt_thread.h"
+#include "basic_types.h"
+#include "cpu_id.h"
 #include <cmath>
+#include <cstring>
 
 #define MAX_PSNR 60
 
+// Note: Defining VPXT_DISABLE_SIMD builds only the c sse kernel.
+#if defined(CPU_X86) && !defined(VPXT_DISABLE_SIMD)
+#include <emmintrin.h>
+#define HAS_SSE_SSE2
+#if (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && \
+    __GNUC_MINOR__ >= 9))) || defined(__clang__) || \
+    (defined(_MSC_VER) && _MSC_VER >= 1700)
+#include <immintrin.h>
+#define HAS_SSE_AVX2
+#endif
+#endif
+
+#if defined(__ARM_NEON__) && !defined(VPXT_DISABLE_SIMD)
+#include <arm_neon.h>
+#define HAS_SSE_NEON
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define VPXT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define VPXT_TARGET(isa)
+#endif
+
+// All kernels sum one row at a time into 32 bit lanes and then fold the row
+// into 64 bit accumulators.  A row of VP8's maximum width (16383) can add at
+// most 16383 * 255 * 255 to a lane, which can not overflow.
+uint64_t vpxt_sse_c(const unsigned char *src, int src_stride,
+                    const unsigned char *dst, int dst_stride,
+                    int width, int height)
+{
+    uint64_t total = 0;
+    int i, j;
+
+    for (i = 0; i < height; i++)
+    {
+        unsigned int row_total = 0;
+
+        for (j = 0; j < width; j++)
+        {
+            int diff = (int)(src[j]) - (int)(dst[j]);
+            row_total += diff * diff;
+        }
+
+        total += row_total;
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+    return total;
+}
+
+#if defined(HAS_SSE_SSE2)
+VPXT_TARGET("sse2")
+static uint64_t vpxt_sse_sse2(const unsigned char *src, int src_stride,
+                              const unsigned char *dst, int dst_stride,
+                              int width, int height)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = _mm_setzero_si128();
+    uint64_t tail_total = 0;
+    uint64_t lanes[2];
+    int i, j;
+
+    for (i = 0; i < height; i++)
+    {
+        __m128i row_total = _mm_setzero_si128();
+
+        for (j = 0; j + 16 <= width; j += 16)
+        {
+            const __m128i a = _mm_loadu_si128((const __m128i *)(src + j));
+            const __m128i b = _mm_loadu_si128((const __m128i *)(dst + j));
+            const __m128i diff_lo = _mm_sub_epi16(_mm_unpacklo_epi8(a, zero),
+                                                  _mm_unpacklo_epi8(b, zero));
+            const __m128i diff_hi = _mm_sub_epi16(_mm_unpackhi_epi8(a, zero),
+                                                  _mm_unpackhi_epi8(b, zero));
+
+            row_total = _mm_add_epi32(row_total,
+                                      _mm_madd_epi16(diff_lo, diff_lo));
+            row_total = _mm_add_epi32(row_total,
+                                      _mm_madd_epi16(diff_hi, diff_hi));
+        }
+
+        total = _mm_add_epi64(total, _mm_unpacklo_epi32(row_total, zero));
+        total = _mm_add_epi64(total, _mm_unpackhi_epi32(row_total, zero));
+
+        for (; j < width; j++)
+        {
+            int diff = (int)(src[j]) - (int)(dst[j]);
+            tail_total += diff * diff;
+        }
+
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+    _mm_storeu_si128((__m128i *)lanes, total);
+    return lanes[0] + lanes[1] + tail_total;
+}
+#endif
+
+#if defined(HAS_SSE_AVX2)
+VPXT_TARGET("avx2")
+static uint64_t vpxt_sse_avx2(const unsigned char *src, int src_stride,
+                              const unsigned char *dst, int dst_stride,
+                              int width, int height)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = _mm256_setzero_si256();
+    uint64_t tail_total = 0;
+    uint64_t lanes[4];
+    int i, j;
+
+    for (i = 0; i < height; i++)
+    {
+        __m256i row_total = _mm256_setzero_si256();
+
+        for (j = 0; j + 32 <= width; j += 32)
+        {
+            const __m256i diff_lo = _mm256_sub_epi16(
+                _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)
+                (src + j))),
+                _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)
+                (dst + j))));
+            const __m256i diff_hi = _mm256_sub_epi16(
+                _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)
+                (src + j + 16))),
+                _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)
+                (dst + j + 16))));
+
+            row_total = _mm256_add_epi32(row_total,
+                                         _mm256_madd_epi16(diff_lo, diff_lo));
+            row_total = _mm256_add_epi32(row_total,
+                                         _mm256_madd_epi16(diff_hi, diff_hi));
+        }
+
+        total = _mm256_add_epi64(total, _mm256_unpacklo_epi32(row_total,
+            zero));
+        total = _mm256_add_epi64(total, _mm256_unpackhi_epi32(row_total,
+            zero));
+
+        for (; j < width; j++)
+        {
+            int diff = (int)(src[j]) - (int)(dst[j]);
+            tail_total += diff * diff;
+        }
+
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+    _mm256_storeu_si256((__m256i *)lanes, total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + tail_total;
+}
+#endif
+
+#if defined(HAS_SSE_NEON)
+static uint64_t vpxt_sse_neon(const unsigned char *src, int src_stride,
+                              const unsigned char *dst, int dst_stride,
+                              int width, int height)
+{
+    uint64x2_t total = vdupq_n_u64(0);
+    uint64_t tail_total = 0;
+    int i, j;
+
+    for (i = 0; i < height; i++)
+    {
+        uint32x4_t row_total = vdupq_n_u32(0);
+
+        for (j = 0; j + 16 <= width; j += 16)
+        {
+            const uint8x16_t a = vld1q_u8(src + j);
+            const uint8x16_t b = vld1q_u8(dst + j);
+            const int16x8_t diff_lo = vreinterpretq_s16_u16(
+                vsubl_u8(vget_low_u8(a), vget_low_u8(b)));
+            const int16x8_t diff_hi = vreinterpretq_s16_u16(
+                vsubl_u8(vget_high_u8(a), vget_high_u8(b)));
+            int32x4_t sq;
+
+            sq = vmull_s16(vget_low_s16(diff_lo), vget_low_s16(diff_lo));
+            sq = vmlal_s16(sq, vget_high_s16(diff_lo), vget_high_s16(diff_lo));
+            sq = vmlal_s16(sq, vget_low_s16(diff_hi), vget_low_s16(diff_hi));
+            sq = vmlal_s16(sq, vget_high_s16(diff_hi), vget_high_s16(diff_hi));
+            row_total = vaddq_u32(row_total, vreinterpretq_u32_s32(sq));
+        }
+
+        total = vpadalq_u32(total, row_total);
+
+        for (; j < width; j++)
+        {
+            int diff = (int)(src[j]) - (int)(dst[j]);
+            tail_total += diff * diff;
+        }
+
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+    return vgetq_lane_u64(total, 0) + vgetq_lane_u64(total, 1) + tail_total;
+}
+#endif
+
+// Returns the requested kernel or NULL if it was not built or the cpu does
+// not support it.
+vpxt_sse_fn_t vpxt_sse_kernel(int kernel_type)
+{
+    switch (kernel_type)
+    {
+    case kSseKernelC:
+        return vpxt_sse_c;
+#if defined(HAS_SSE_SSE2)
+    case kSseKernelSSE2:
+        if (libyuv::TestCpuFlag(libyuv::kCpuHasSSE2))
+            return vpxt_sse_sse2;
+        break;
+#endif
+#if defined(HAS_SSE_AVX2)
+    case kSseKernelAVX2:
+        if (libyuv::TestCpuFlag(libyuv::kCpuHasAVX2))
+            return vpxt_sse_avx2;
+        break;
+#endif
+#if defined(HAS_SSE_NEON)
+    case kSseKernelNEON:
+        if (libyuv::TestCpuFlag(libyuv::kCpuHasNEON))
+            return vpxt_sse_neon;
+        break;
+#endif
+    default:
+        break;
+    }
+
+    return NULL;
+}
+
+const char *vpxt_sse_kernel_name(int kernel_type)
+{
+    switch (kernel_type)
+    {
+    case kSseKernelC:
+        return "C";
+    case kSseKernelSSE2:
+        return "SSE2";
+    case kSseKernelAVX2:
+        return "AVX2";
+    case kSseKernelNEON:
+        return "NEON";
+    default:
+        return "Unknown";
+    }
+}
+
+// Picks the fastest kernel the cpu supports.  libyuv::MaskCpuFlags can be
+// used to force a slower kernel.
+vpxt_sse_fn_t vpxt_sse_select_kernel()
+{
+    vpxt_sse_fn_t kernel;
+
+    if ((kernel = vpxt_sse_kernel(kSseKernelAVX2)))
+        return kernel;
+
+    if ((kernel = vpxt_sse_kernel(kSseKernelSSE2)))
+        return kernel;
+
+    if ((kernel = vpxt_sse_kernel(kSseKernelNEON)))
+        return kernel;
+
+    return vpxt_sse_c;
+}
+
+static vpxt_sse_fn_t sse_kernel = NULL;
+static vpxt_once_t sse_kernel_once = VPXT_ONCE_INIT;
+
+static void sse_kernel_init()
+{
+    sse_kernel = vpxt_sse_select_kernel();
+}
+
+uint64_t vpxt_sse(const unsigned char *src, int src_stride,
+                  const unsigned char *dst, int dst_stride,
+                  int width, int height)
+{
+    // metric threads call this concurrently, the kernel is selected once
+    vpxt_once(&sse_kernel_once, sse_kernel_init);
+
+    return sse_kernel(src, src_stride, dst, dst_stride, width, height);
+}
+
 
 double vp8_mse_2_psnr_tester(double samples, double peak, double mse)
 {
@@ -20,56 +312,150 @@ double vp8_mse_2_psnr_tester(double samples, double peak, double mse)
     return psnr;
 }
 
+// Sets up metrics for a new frame.  The segment layout keeps segments at
+// least 64 pixels wide and is only used when run_artifact is set.
+void vpxt_init_frame_metrics(YV12_BUFFER_CONFIG *source, int run_artifact,
+                             VPXT_FRAME_METRICS *metrics)
+{
+    memset(metrics, 0, sizeof(*metrics));
+    metrics->run_artifact = run_artifact;
+
+    if (!run_artifact)
+        return;
+
+    // try to keep at least 64 pixel segments
+    metrics->width_segments = source->y_width / 64;
+    metrics->height_segments = metrics->width_segments;
+
+    if(metrics->height_segments > VPXT_MAX_SEGMENTS)
+        metrics->height_segments = VPXT_MAX_SEGMENTS;
+    if(metrics->width_segments > VPXT_MAX_SEGMENTS)
+        metrics->width_segments = VPXT_MAX_SEGMENTS;
+
+    metrics->segment_height =
+        (source->y_height / metrics->height_segments == 0) ? 1 :
+        ((metrics->height_segments - 1) + source->y_height) /
+        metrics->height_segments;
+    metrics->segment_width =
+        (source->y_width / metrics->width_segments == 0) ? 1 :
+        ((metrics->width_segments - 1) + source->y_width) /
+        metrics->width_segments;
+}
+
+// Adds the squared error of rows [row, row + rows) of the Y plane, split by
+// segment when artifact detection is on.
+void vpxt_add_luma_sse(const VPXT_FRAME_METRICS *metrics,
+                       const unsigned char *src, int src_stride,
+                       const unsigned char *dst, int dst_stride,
+                       int width, int row, int rows, uint64_t *sse,
+                       uint64_t segment_sse[][VPXT_MAX_SEGMENTS])
+{
+    int j;
+
+    if (!metrics->run_artifact)
+    {
+        *sse += vpxt_sse(src, src_stride, dst, dst_stride, width, rows);
+        return;
+    }
+
+    for (j = 0; j * metrics->segment_width < width; j++)
+    {
+        int col = j * metrics->segment_width;
+        int cols = width - col;
+        uint64_t segment;
+
+        if (cols > metrics->segment_width)
+            cols = metrics->segment_width;
+
+        segment = vpxt_sse(src + col, src_stride, dst + col, dst_stride, cols,
+                           rows);
+        segment_sse[row / metrics->segment_height][j] += segment;
+        *sse += segment;
+    }
+}
+
+// Squared error of every plane, one plane at a time.
+void vpxt_frame_sse(YV12_BUFFER_CONFIG *source, YV12_BUFFER_CONFIG *dest,
+                    VPXT_FRAME_METRICS *metrics)
+{
+    int row;
+
+    metrics->sse[0] = 0;
+
+    if (metrics->run_artifact)
+    {
+        // gather totals for internal segments one segment row at a time
+        for (row = 0; row < source->y_height; row += metrics->segment_height)
+        {
+            int rows = source->y_height - row;
+
+            if (rows > metrics->segment_height)
+                rows = metrics->segment_height;
+
+            vpxt_add_luma_sse(metrics,
+                source->y_buffer + row * source->y_stride, source->y_stride,
+                dest->y_buffer + row * dest->y_stride, dest->y_stride,
+                source->y_width, row, rows, &metrics->sse[0],
+                metrics->segment_sse);
+        }
+    }
+    else
+        metrics->sse[0] = vpxt_sse(source->y_buffer, source->y_stride,
+            dest->y_buffer, dest->y_stride, source->y_width,
+            source->y_height);
+
+    metrics->sse[1] = vpxt_sse(source->u_buffer, source->uv_stride,
+        dest->u_buffer, dest->uv_stride, source->uv_width, source->uv_height);
+    metrics->sse[2] = vpxt_sse(source->v_buffer, source->uv_stride,
+        dest->v_buffer, dest->uv_stride, source->uv_width, source->uv_height);
+}
+
 double vp8_calcpsnr_tester(YV12_BUFFER_CONFIG *source, YV12_BUFFER_CONFIG *dest,
                            double *ypsnr, double *upsnr, double *vpsnr,
                            double *sq_error, int print_out,
                            int& possible_artifact)
+{
+    VPXT_FRAME_METRICS metrics;
+
+    vpxt_init_frame_metrics(source,
+        possible_artifact == kRunArtifactDetection, &metrics);
+    vpxt_frame_sse(source, dest, &metrics);
+
+    return vpxt_psnr_from_metrics(source, &metrics, ypsnr, upsnr, vpsnr,
+        sq_error, print_out, possible_artifact);
+}
+
+// Turns the squared error totals gathered for a frame into PSNRs and runs
+// artifact detection on the Y segments.
+double vpxt_psnr_from_metrics(YV12_BUFFER_CONFIG *source,
+                              const VPXT_FRAME_METRICS *metrics,
+                              double *ypsnr, double *upsnr, double *vpsnr,
+                              double *sq_error, int print_out,
+                              int& possible_artifact)
 {
     int i, j;
-    int diff;
     double frame_psnr;
     double total;
     double grand_total;
-    unsigned char *src = source->y_buffer;
-    unsigned char *dst = dest->y_buffer;
 
     double sub_frame_ypsnr[16][16] = {0}; // break the frame into 16 by 16
     double sub_frame_total[16][16] = {0}; // hold 16 by 16 frame total data
 
-    // try to keep at least 64 pixel segments
-    int width_segments = source->y_width / 64;
-    int height_segments = width_segments;
-
-    if(height_segments > 16)
-        height_segments = 16;
-    if(width_segments > 16)
-        width_segments = 16;
+    int width_segments = metrics->width_segments;
+    int height_segments = metrics->height_segments;
 
-    total = 0.0;
     grand_total = 0.0;
 
-    // Loop throught the Y plane raw and reconstruction data summing
-    // (square differences)
-    for (i = 0; i < source->y_height; i++)
+    if(possible_artifact == kRunArtifactDetection)
     {
-        for (j = 0; j < source->y_width; j++)
-        {
-            diff        = (int)(src[j]) - (int)(dst[j]);
-            total      += diff * diff;
-
-            // gather totals for internal segments
-            if(possible_artifact == kRunArtifactDetection)
-                sub_frame_total[i / ((source->y_height / height_segments == 0)
-                ? 1 : ((height_segments - 1) + source->y_height) /
-                height_segments)] [j / ((source->y_width/width_segments ==0 )
-                ? 1 : ((width_segments - 1 ) + source->y_width) /
-                width_segments)] += diff * diff;
-        }
-
-        src += source->y_stride;
-        dst += dest->y_stride;
+        for (i = 0; i < VPXT_MAX_SEGMENTS; i++)
+            for (j = 0; j < VPXT_MAX_SEGMENTS; j++)
+                sub_frame_total[i][j] = (double)metrics->segment_sse[i][j];
     }
 
+    // Sum the square differences of the Y plane raw and reconstruction data
+    total = (double)metrics->sse[0];
+
     // Work out Y PSNR
     *ypsnr = vp8_mse_2_psnr_tester(source->y_height * source->y_width, 255.0,
         total);
@@ -160,21 +546,8 @@ double vp8_calcpsnr_tester(YV12_BUFFER_CONFIG *source, YV12_BUFFER_CONFIG *dest,
     grand_total += total;
     total = 0;
 
-    // Loop through the U plane
-    src = source->u_buffer;
-    dst = dest->u_buffer;
-
-    for (i = 0; i < source->uv_height; i++)
-    {
-        for (j = 0; j < source->uv_width; j++)
-        {
-            diff        = (int)(src[j]) - (int)(dst[j]);
-            total      += diff * diff;
-        }
-
-        src += source->uv_stride;
-        dst += dest->uv_stride;
-    }
+    // U plane
+    total = (double)metrics->sse[1];
 
     // Work out U PSNR
     *upsnr = vp8_mse_2_psnr_tester(source->uv_height * source->uv_width, 255.0,
@@ -182,21 +555,8 @@ double vp8_calcpsnr_tester(YV12_BUFFER_CONFIG *source, YV12_BUFFER_CONFIG *dest,
     grand_total += total;
     total = 0;
 
-    // V PSNR
-    src = source->v_buffer;
-    dst = dest->v_buffer;
-
-    for (i = 0; i < source->uv_height; i++)
-    {
-        for (j = 0; j < source->uv_width; j++)
-        {
-            diff        = (int)(src[j]) - (int)(dst[j]);
-            total      += diff * diff;
-        }
-
-        src += source->uv_stride;
-        dst += dest->uv_stride;
-    }
+    // V plane
+    total = (double)metrics->sse[2];
 
     // Work out UV PSNR
     *vpsnr = vp8_mse_2_psnr_tester(source->uv_height * source->uv_width, 255.0,
@@ -10,29 +10,214 @@
  ***************************************************************************/
 
 #include "yv12config.h"
+#include "vpxt_psnr.h"
+#include "basic_types.h"
+#include "cpu_id.h"
 #include "math.h"
+#include <stdlib.h>
+#include <string.h>
 
 #define C1 (float)(64 * 64 * 0.01*255*0.01*255)
 #define C2 (float)(64 * 64 * 0.03*255*0.03*255)
 
-static int width_y;
-static int height_y;
-static int height_uv;
-static int width_uv;
-static int stride_uv;
-static int stride;
-static int lumimask;
-static int luminance;
-static double plane_summed_weights = 0;
+// bands shorter than this are not worth handing to another thread
+#define SSIM_MIN_BAND_ROWS 16
+
+// Note: Defining VPXT_DISABLE_SIMD builds only the c ssim kernels.
+#if defined(CPU_X86) && !defined(VPXT_DISABLE_SIMD)
+#include <emmintrin.h>
+#define HAS_SSIM_SSE2
+#endif
+
+#if defined(__ARM_NEON__) && !defined(VPXT_DISABLE_SIMD)
+#include <arm_neon.h>
+#define HAS_SSIM_NEON
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define VPXT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define VPXT_TARGET(isa)
+#endif
+
+// Adds one row to and removes one row from the running column sums.  When
+// col_sse is set the squared error of the added rows is also added to it
+// column by column.
+typedef void (*ssim_col_update_fn_t)(const unsigned char *add1,
+                                     const unsigned char *add2,
+                                     const unsigned char *sub1,
+                                     const unsigned char *sub2,
+                                     VPXT_SSIM_BAND *band, int *col_sse,
+                                     int width);
+
+// Computes vp8_similarity for count consecutive 8x8 windows.
+typedef void (*ssim_similarity_fn_t)(const VPXT_SSIM_BAND *band, int count);
+
+// Sums a 7 row column of the Google SSIM gaussian into the band's block
+// arrays for every column of the row.
+typedef void (*ssimg_vertical_fn_t)(const unsigned char *org,
+                                    const unsigned char *rec,
+                                    int stride1, int stride2,
+                                    VPXT_SSIM_BAND *band, int width);
+
+struct ssim_plane
+{
+    VPXT_SSIM_CTX *ctx;
+    const unsigned char *img1;
+    const unsigned char *img2;
+    int stride_img1;
+    int stride_img2;
+    int width;
+    int height;
+    int rows;
+    int band_count;
+
+    // when set, squared error is gathered as rows are read
+    VPXT_FRAME_METRICS *metrics;
+    int plane_index;
+
+    ssim_col_update_fn_t col_update;
+    ssim_similarity_fn_t similarity;
+    ssimg_vertical_fn_t ssimg_vertical;
+};
+
+static void free_band(VPXT_SSIM_BAND *band)
+{
+    free(band->img1_sum);
+    free(band->img2_sum);
+    free(band->img1_sq_sum);
+    free(band->img2_sq_sum);
+    free(band->img12_mul_sum);
+    free(band->block1);
+    free(band->block2);
+    free(band->block11);
+    free(band->block22);
+    free(band->block12);
+    free(band->similarity);
+    free(band->col_sse);
+    memset(band, 0, sizeof(*band));
+}
+
+static int alloc_band(VPXT_SSIM_BAND *band, int width)
+{
+    memset(band, 0, sizeof(*band));
+
+    band->img1_sum = (short *)malloc(width * sizeof(short));
+    band->img2_sum = (short *)malloc(width * sizeof(short));
+    band->img1_sq_sum = (int *)malloc(width * sizeof(int));
+    band->img2_sq_sum = (int *)malloc(width * sizeof(int));
+    band->img12_mul_sum = (int *)malloc(width * sizeof(int));
+    band->block1 = (int *)malloc(width * sizeof(int));
+    band->block2 = (int *)malloc(width * sizeof(int));
+    band->block11 = (int *)malloc(width * sizeof(int));
+    band->block22 = (int *)malloc(width * sizeof(int));
+    band->block12 = (int *)malloc(width * sizeof(int));
+    band->similarity = (double *)malloc(width * sizeof(double));
+    band->col_sse = (int *)malloc(width * sizeof(int));
+
+    if (!band->img1_sum || !band->img2_sum || !band->img1_sq_sum ||
+        !band->img2_sq_sum || !band->img12_mul_sum || !band->block1 ||
+        !band->block2 || !band->block11 || !band->block22 ||
+        !band->block12 || !band->similarity || !band->col_sse)
+    {
+        free_band(band);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int select_ssim_kernel()
+{
+#if defined(HAS_SSIM_SSE2)
+    if (libyuv::TestCpuFlag(libyuv::kCpuHasSSE2))
+        return kSseKernelSSE2;
+#endif
+#if defined(HAS_SSIM_NEON)
+    if (libyuv::TestCpuFlag(libyuv::kCpuHasNEON))
+        return kSseKernelNEON;
+#endif
+
+    return kSseKernelC;
+}
+
+void vpxt_ssim_ctx_init(VPXT_SSIM_CTX *ctx)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->kernel_type = select_ssim_kernel();
+}
+
+void vpxt_ssim_ctx_free(VPXT_SSIM_CTX *ctx)
+{
+    int i;
+    VPXT_WORKER_POOL *pool = ctx->pool;
+    int kernel_type = ctx->kernel_type;
+
+    for (i = 0; i < ctx->band_count; i++)
+        free_band(&ctx->bands[i]);
+
+    free(ctx->bands);
+    free(ctx->img12_sum_block);
+    free(ctx->zero_row);
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->pool = pool;
+    ctx->kernel_type = kernel_type;
+}
+
+// Sizes the scratch buffers for a width x height frame.  Buffers are only
+// reallocated when the frame geometry changes.
+int vpxt_ssim_ctx_alloc(VPXT_SSIM_CTX *ctx, int width, int height,
+                        int width_uv, int height_uv)
+{
+    int band_count = ctx->pool ? ctx->pool->thread_count + 1 : 1;
+    int i;
+
+    // the luma pass writes up to row (height - 8) / 2 of the block sums
+    if (height_uv < (1 + height) / 2)
+        height_uv = (1 + height) / 2;
 
-static short img12_sum_block[8*4096*4096*2] ;
+    if (ctx->alloc_width == width && ctx->alloc_height == height &&
+        ctx->width_uv == width_uv && ctx->alloc_height_uv == height_uv &&
+        ctx->band_count == band_count && ctx->bands)
+        return 0;
 
-static short img1_sum[8*4096*2];
-static short img2_sum[8*4096*2];
-static int   img1_sq_sum[8*4096*2];
-static int   img2_sq_sum[8*4096*2];
-static int   img12_mul_sum[8*4096*2];
+    vpxt_ssim_ctx_free(ctx);
 
+    if (width_uv > width)
+        width = width_uv;
+
+    // the luma pass stores the sum of every other 8x8 block at half
+    // resolution for the chroma passes to weight by
+    ctx->img12_sum_block = (short *)calloc(width_uv * height_uv,
+        sizeof(short));
+    ctx->zero_row = (unsigned char *)calloc(width, 1);
+    ctx->bands = (VPXT_SSIM_BAND *)calloc(band_count, sizeof(VPXT_SSIM_BAND));
+
+    if (!ctx->img12_sum_block || !ctx->zero_row || !ctx->bands)
+    {
+        vpxt_ssim_ctx_free(ctx);
+        return -1;
+    }
+
+    for (i = 0; i < band_count; i++)
+    {
+        if (alloc_band(&ctx->bands[i], width))
+        {
+            vpxt_ssim_ctx_free(ctx);
+            return -1;
+        }
+
+        ctx->band_count++;
+    }
+
+    ctx->alloc_width = width;
+    ctx->alloc_height = height;
+    ctx->width_uv = width_uv;
+    ctx->alloc_height_uv = height_uv;
+
+    return 0;
+}
 
 double vp8_similarity
 (
@@ -56,244 +241,733 @@ double vp8_similarity
     return (2 * mu_xy + C1) * (2 * theta_xy + C2) / ((mu_x2 + mu_y2 + C1) * (theta_x2 + theta_y2 + C2));
 }
 
-double vp8_ssim
-(
-    const unsigned char *img1,
-    const unsigned char *img2,
-    int stride_img1,
-    int stride_img2,
-    int width,
-    int height
-)
+static void ssim_col_update_c(const unsigned char *add1,
+                              const unsigned char *add2,
+                              const unsigned char *sub1,
+                              const unsigned char *sub2,
+                              VPXT_SSIM_BAND *band, int *col_sse,
+                              int width)
+{
+    int x;
+
+    for (x = 0; x < width; x++)
+    {
+        band->img1_sum[x]      += add1[x] - sub1[x];
+        band->img2_sum[x]      += add2[x] - sub2[x];
+        band->img1_sq_sum[x]   += add1[x] * add1[x] - sub1[x] * sub1[x];
+        band->img2_sq_sum[x]   += add2[x] * add2[x] - sub2[x] * sub2[x];
+        band->img12_mul_sum[x] += add1[x] * add2[x] - sub1[x] * sub2[x];
+
+        if (col_sse)
+            col_sse[x] += (add1[x] - add2[x]) * (add1[x] - add2[x]);
+    }
+}
+
+static void ssim_similarity_c(const VPXT_SSIM_BAND *band, int count)
 {
-    int x, y, x2, y2, img1_block, img2_block, img1_sq_block, img2_sq_block, img12_mul_block, temp;
+    int x;
 
-    double plane_quality, weight, mean;
+    for (x = 0; x < count; x++)
+        band->similarity[x] = vp8_similarity(band->block1[x], band->block2[x],
+            band->block11[x], band->block22[x], band->block12[x]);
+}
 
-    short *img1_sum_ptr1, *img1_sum_ptr2;
-    short *img2_sum_ptr1, *img2_sum_ptr2;
-    int *img1_sq_sum_ptr1, *img1_sq_sum_ptr2;
-    int *img2_sq_sum_ptr1, *img2_sq_sum_ptr2;
-    int *img12_mul_sum_ptr1, *img12_mul_sum_ptr2;
+#if defined(HAS_SSIM_SSE2)
+VPXT_TARGET("sse2")
+static void ssim_col_update_sse2(const unsigned char *add1,
+                                 const unsigned char *add2,
+                                 const unsigned char *sub1,
+                                 const unsigned char *sub2,
+                                 VPXT_SSIM_BAND *band, int *col_sse,
+                                 int width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x;
 
-    plane_quality = 0;
+    for (x = 0; x + 8 <= width; x += 8)
+    {
+        const __m128i a1 = _mm_unpacklo_epi8(
+            _mm_loadl_epi64((const __m128i *)(add1 + x)), zero);
+        const __m128i a2 = _mm_unpacklo_epi8(
+            _mm_loadl_epi64((const __m128i *)(add2 + x)), zero);
+        const __m128i s1 = _mm_unpacklo_epi8(
+            _mm_loadl_epi64((const __m128i *)(sub1 + x)), zero);
+        const __m128i s2 = _mm_unpacklo_epi8(
+            _mm_loadl_epi64((const __m128i *)(sub2 + x)), zero);
+        const __m128i neg_s1 = _mm_sub_epi16(zero, s1);
+        const __m128i neg_s2 = _mm_sub_epi16(zero, s2);
+
+        // interleaving (add, sub) with (add, -sub) lets madd produce
+        // add * add - sub * sub in 32 bit lanes
+        const __m128i p_lo = _mm_unpacklo_epi16(a1, s1);
+        const __m128i p_hi = _mm_unpackhi_epi16(a1, s1);
+        const __m128i q_lo = _mm_unpacklo_epi16(a2, s2);
+        const __m128i q_hi = _mm_unpackhi_epi16(a2, s2);
+        const __m128i pn_lo = _mm_unpacklo_epi16(a1, neg_s1);
+        const __m128i pn_hi = _mm_unpackhi_epi16(a1, neg_s1);
+        const __m128i qn_lo = _mm_unpacklo_epi16(a2, neg_s2);
+        const __m128i qn_hi = _mm_unpackhi_epi16(a2, neg_s2);
+
+        __m128i sum1 = _mm_loadu_si128((const __m128i *)(band->img1_sum + x));
+        __m128i sum2 = _mm_loadu_si128((const __m128i *)(band->img2_sum + x));
+        int *sq1 = band->img1_sq_sum + x;
+        int *sq2 = band->img2_sq_sum + x;
+        int *mul = band->img12_mul_sum + x;
+
+        sum1 = _mm_add_epi16(sum1, _mm_sub_epi16(a1, s1));
+        sum2 = _mm_add_epi16(sum2, _mm_sub_epi16(a2, s2));
+        _mm_storeu_si128((__m128i *)(band->img1_sum + x), sum1);
+        _mm_storeu_si128((__m128i *)(band->img2_sum + x), sum2);
+
+        _mm_storeu_si128((__m128i *)sq1, _mm_add_epi32(
+            _mm_loadu_si128((const __m128i *)sq1), _mm_madd_epi16(p_lo, pn_lo)));
+        _mm_storeu_si128((__m128i *)(sq1 + 4), _mm_add_epi32(
+            _mm_loadu_si128((const __m128i *)(sq1 + 4)),
+            _mm_madd_epi16(p_hi, pn_hi)));
+        _mm_storeu_si128((__m128i *)sq2, _mm_add_epi32(
+            _mm_loadu_si128((const __m128i *)sq2), _mm_madd_epi16(q_lo, qn_lo)));
+        _mm_storeu_si128((__m128i *)(sq2 + 4), _mm_add_epi32(
+            _mm_loadu_si128((const __m128i *)(sq2 + 4)),
+            _mm_madd_epi16(q_hi, qn_hi)));
+        _mm_storeu_si128((__m128i *)mul, _mm_add_epi32(
+            _mm_loadu_si128((const __m128i *)mul), _mm_madd_epi16(p_lo, qn_lo)));
+        _mm_storeu_si128((__m128i *)(mul + 4), _mm_add_epi32(
+            _mm_loadu_si128((const __m128i *)(mul + 4)),
+            _mm_madd_epi16(p_hi, qn_hi)));
+
+        if (col_sse)
+        {
+            const __m128i diff = _mm_sub_epi16(a1, a2);
+            const __m128i diff_lo = _mm_unpacklo_epi16(diff, zero);
+            const __m128i diff_hi = _mm_unpackhi_epi16(diff, zero);
+
+            _mm_storeu_si128((__m128i *)(col_sse + x), _mm_add_epi32(
+                _mm_loadu_si128((const __m128i *)(col_sse + x)),
+                _mm_madd_epi16(diff_lo, diff_lo)));
+            _mm_storeu_si128((__m128i *)(col_sse + x + 4), _mm_add_epi32(
+                _mm_loadu_si128((const __m128i *)(col_sse + x + 4)),
+                _mm_madd_epi16(diff_hi, diff_hi)));
+        }
+    }
 
-    if (lumimask)
-        plane_summed_weights = 0.0f;
-    else
-        plane_summed_weights = (height - 7) * (width - 7);
+    for (; x < width; x++)
+    {
+        band->img1_sum[x]      += add1[x] - sub1[x];
+        band->img2_sum[x]      += add2[x] - sub2[x];
+        band->img1_sq_sum[x]   += add1[x] * add1[x] - sub1[x] * sub1[x];
+        band->img2_sq_sum[x]   += add2[x] * add2[x] - sub2[x] * sub2[x];
+        band->img12_mul_sum[x] += add1[x] * add2[x] - sub1[x] * sub2[x];
+
+        if (col_sse)
+            col_sse[x] += (add1[x] - add2[x]) * (add1[x] - add2[x]);
+    }
+}
 
-    // some prologue for the main loop
-    temp = 8 * width;
+// The integer terms of vp8_similarity are below 2^31 so they are exact in
+// double precision.  Rounding them to float and finishing in single
+// precision matches the scalar expression, which is evaluated in float.
+VPXT_TARGET("sse2")
+static __m128 ssim_int_terms_to_float(__m128d lo, __m128d hi)
+{
+    return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
 
-    img1_sum_ptr1      = img1_sum + temp;
-    img2_sum_ptr1      = img2_sum + temp;
-    img1_sq_sum_ptr1   = img1_sq_sum + temp;
-    img2_sq_sum_ptr1   = img2_sq_sum + temp;
-    img12_mul_sum_ptr1 = img12_mul_sum + temp;
+VPXT_TARGET("sse2")
+static void ssim_similarity_sse2(const VPXT_SSIM_BAND *band, int count)
+{
+    const __m128d sixty_four = _mm_set1_pd(64.0);
+    const __m128d two = _mm_set1_pd(2.0);
+    const __m128 c1 = _mm_set1_ps(C1);
+    const __m128 c2 = _mm_set1_ps(C2);
+    __m128d mu_x[2], mu_y[2], pre_x2[2], pre_y2[2], pre_xy[2];
+    __m128d a[2], b[2], c[2], d[2];
+    int x, i;
+
+    for (x = 0; x + 4 <= count; x += 4)
+    {
+        const __m128i b1 = _mm_loadu_si128((const __m128i *)(band->block1 + x));
+        const __m128i b2 = _mm_loadu_si128((const __m128i *)(band->block2 + x));
+        const __m128i b11 =
+            _mm_loadu_si128((const __m128i *)(band->block11 + x));
+        const __m128i b22 =
+            _mm_loadu_si128((const __m128i *)(band->block22 + x));
+        const __m128i b12 =
+            _mm_loadu_si128((const __m128i *)(band->block12 + x));
+        __m128 num, den, sim;
+
+        mu_x[0] = _mm_cvtepi32_pd(b1);
+        mu_x[1] = _mm_cvtepi32_pd(_mm_shuffle_epi32(b1, 0x0E));
+        mu_y[0] = _mm_cvtepi32_pd(b2);
+        mu_y[1] = _mm_cvtepi32_pd(_mm_shuffle_epi32(b2, 0x0E));
+        pre_x2[0] = _mm_cvtepi32_pd(b11);
+        pre_x2[1] = _mm_cvtepi32_pd(_mm_shuffle_epi32(b11, 0x0E));
+        pre_y2[0] = _mm_cvtepi32_pd(b22);
+        pre_y2[1] = _mm_cvtepi32_pd(_mm_shuffle_epi32(b22, 0x0E));
+        pre_xy[0] = _mm_cvtepi32_pd(b12);
+        pre_xy[1] = _mm_cvtepi32_pd(_mm_shuffle_epi32(b12, 0x0E));
+
+        for (i = 0; i < 2; i++)
+        {
+            const __m128d mu_x2 = _mm_mul_pd(mu_x[i], mu_x[i]);
+            const __m128d mu_y2 = _mm_mul_pd(mu_y[i], mu_y[i]);
+            const __m128d mu_xy = _mm_mul_pd(mu_x[i], mu_y[i]);
+            const __m128d theta_x2 =
+                _mm_sub_pd(_mm_mul_pd(sixty_four, pre_x2[i]), mu_x2);
+            const __m128d theta_y2 =
+                _mm_sub_pd(_mm_mul_pd(sixty_four, pre_y2[i]), mu_y2);
+            const __m128d theta_xy =
+                _mm_sub_pd(_mm_mul_pd(sixty_four, pre_xy[i]), mu_xy);
+
+            a[i] = _mm_mul_pd(two, mu_xy);
+            b[i] = _mm_mul_pd(two, theta_xy);
+            c[i] = _mm_add_pd(mu_x2, mu_y2);
+            d[i] = _mm_add_pd(theta_x2, theta_y2);
+        }
 
-    for (x = 0; x < width; x++)
+        num = _mm_mul_ps(_mm_add_ps(ssim_int_terms_to_float(a[0], a[1]), c1),
+                         _mm_add_ps(ssim_int_terms_to_float(b[0], b[1]), c2));
+        den = _mm_mul_ps(_mm_add_ps(ssim_int_terms_to_float(c[0], c[1]), c1),
+                         _mm_add_ps(ssim_int_terms_to_float(d[0], d[1]), c2));
+        sim = _mm_div_ps(num, den);
+
+        _mm_storeu_pd(band->similarity + x, _mm_cvtps_pd(sim));
+        _mm_storeu_pd(band->similarity + x + 2,
+                      _mm_cvtps_pd(_mm_movehl_ps(sim, sim)));
+    }
+
+    for (; x < count; x++)
+        band->similarity[x] = vp8_similarity(band->block1[x], band->block2[x],
+            band->block11[x], band->block22[x], band->block12[x]);
+}
+#endif
+
+#if defined(HAS_SSIM_NEON)
+static void ssim_col_update_neon(const unsigned char *add1,
+                                 const unsigned char *add2,
+                                 const unsigned char *sub1,
+                                 const unsigned char *sub2,
+                                 VPXT_SSIM_BAND *band, int *col_sse,
+                                 int width)
+{
+    int x;
+
+    for (x = 0; x + 8 <= width; x += 8)
     {
-        img1_sum[x]      = img1[x];
-        img2_sum[x]      = img2[x];
-        img1_sq_sum[x]   = img1[x] * img1[x];
-        img2_sq_sum[x]   = img2[x] * img2[x];
-        img12_mul_sum[x] = img1[x] * img2[x];
+        const uint16x8_t a1 = vmovl_u8(vld1_u8(add1 + x));
+        const uint16x8_t a2 = vmovl_u8(vld1_u8(add2 + x));
+        const uint16x8_t s1 = vmovl_u8(vld1_u8(sub1 + x));
+        const uint16x8_t s2 = vmovl_u8(vld1_u8(sub2 + x));
+        int16x8_t sum1 = vld1q_s16(band->img1_sum + x);
+        int16x8_t sum2 = vld1q_s16(band->img2_sum + x);
+        int32x4_t sq1_lo = vld1q_s32(band->img1_sq_sum + x);
+        int32x4_t sq1_hi = vld1q_s32(band->img1_sq_sum + x + 4);
+        int32x4_t sq2_lo = vld1q_s32(band->img2_sq_sum + x);
+        int32x4_t sq2_hi = vld1q_s32(band->img2_sq_sum + x + 4);
+        int32x4_t mul_lo = vld1q_s32(band->img12_mul_sum + x);
+        int32x4_t mul_hi = vld1q_s32(band->img12_mul_sum + x + 4);
+
+        sum1 = vaddq_s16(sum1, vreinterpretq_s16_u16(vsubq_u16(a1, s1)));
+        sum2 = vaddq_s16(sum2, vreinterpretq_s16_u16(vsubq_u16(a2, s2)));
+
+        sq1_lo = vaddq_s32(sq1_lo, vreinterpretq_s32_u32(vsubq_u32(
+            vmull_u16(vget_low_u16(a1), vget_low_u16(a1)),
+            vmull_u16(vget_low_u16(s1), vget_low_u16(s1)))));
+        sq1_hi = vaddq_s32(sq1_hi, vreinterpretq_s32_u32(vsubq_u32(
+            vmull_u16(vget_high_u16(a1), vget_high_u16(a1)),
+            vmull_u16(vget_high_u16(s1), vget_high_u16(s1)))));
+        sq2_lo = vaddq_s32(sq2_lo, vreinterpretq_s32_u32(vsubq_u32(
+            vmull_u16(vget_low_u16(a2), vget_low_u16(a2)),
+            vmull_u16(vget_low_u16(s2), vget_low_u16(s2)))));
+        sq2_hi = vaddq_s32(sq2_hi, vreinterpretq_s32_u32(vsubq_u32(
+            vmull_u16(vget_high_u16(a2), vget_high_u16(a2)),
+            vmull_u16(vget_high_u16(s2), vget_high_u16(s2)))));
+        mul_lo = vaddq_s32(mul_lo, vreinterpretq_s32_u32(vsubq_u32(
+            vmull_u16(vget_low_u16(a1), vget_low_u16(a2)),
+            vmull_u16(vget_low_u16(s1), vget_low_u16(s2)))));
+        mul_hi = vaddq_s32(mul_hi, vreinterpretq_s32_u32(vsubq_u32(
+            vmull_u16(vget_high_u16(a1), vget_high_u16(a2)),
+            vmull_u16(vget_high_u16(s1), vget_high_u16(s2)))));
+
+        vst1q_s16(band->img1_sum + x, sum1);
+        vst1q_s16(band->img2_sum + x, sum2);
+        vst1q_s32(band->img1_sq_sum + x, sq1_lo);
+        vst1q_s32(band->img1_sq_sum + x + 4, sq1_hi);
+        vst1q_s32(band->img2_sq_sum + x, sq2_lo);
+        vst1q_s32(band->img2_sq_sum + x + 4, sq2_hi);
+        vst1q_s32(band->img12_mul_sum + x, mul_lo);
+        vst1q_s32(band->img12_mul_sum + x + 4, mul_hi);
+
+        if (col_sse)
+        {
+            const int16x8_t diff = vreinterpretq_s16_u16(vsubq_u16(a1, a2));
 
-        img1_sum_ptr1[x]      = 0;
-        img2_sum_ptr1[x]      = 0;
-        img1_sq_sum_ptr1[x]   = 0;
-        img2_sq_sum_ptr1[x]   = 0;
-        img12_mul_sum_ptr1[x] = 0;
+            vst1q_s32(col_sse + x, vmlal_s16(vld1q_s32(col_sse + x),
+                vget_low_s16(diff), vget_low_s16(diff)));
+            vst1q_s32(col_sse + x + 4, vmlal_s16(vld1q_s32(col_sse + x + 4),
+                vget_high_s16(diff), vget_high_s16(diff)));
+        }
     }
 
-    // the main loop
-    for (y = 1; y < height; y++)
+    for (; x < width; x++)
     {
-        img1 += stride_img1;
-        img2 += stride_img2;
+        band->img1_sum[x]      += add1[x] - sub1[x];
+        band->img2_sum[x]      += add2[x] - sub2[x];
+        band->img1_sq_sum[x]   += add1[x] * add1[x] - sub1[x] * sub1[x];
+        band->img2_sq_sum[x]   += add2[x] * add2[x] - sub2[x] * sub2[x];
+        band->img12_mul_sum[x] += add1[x] * add2[x] - sub1[x] * sub2[x];
+
+        if (col_sse)
+            col_sse[x] += (add1[x] - add2[x]) * (add1[x] - add2[x]);
+    }
+}
+#endif
 
-        temp = (y - 1) % 9 * width;
+static void ssim_row_sse(const ssim_plane *plane, VPXT_SSIM_BAND *band,
+                         int row)
+{
+    const unsigned char *src = plane->img1 + row * plane->stride_img1;
+    const unsigned char *dst = plane->img2 + row * plane->stride_img2;
 
-        img1_sum_ptr1      = img1_sum + temp;
-        img2_sum_ptr1      = img2_sum + temp;
-        img1_sq_sum_ptr1   = img1_sq_sum + temp;
-        img2_sq_sum_ptr1   = img2_sq_sum + temp;
-        img12_mul_sum_ptr1 = img12_mul_sum + temp;
+    if (plane->plane_index == 0)
+        vpxt_add_luma_sse(plane->metrics, src, plane->stride_img1, dst,
+                          plane->stride_img2, plane->width, row, 1,
+                          &band->sse, band->segment_sse);
+    else
+        band->sse += vpxt_sse(src, plane->stride_img1, dst, plane->stride_img2,
+                              plane->width, 1);
+}
+
+// Folds the per column squared error into the band totals after row has
+// been added.  Luma with artifact detection is folded at the end of every
+// segment row, everything else once the band's last row is in.  A column
+// can collect at most 16383 rows of 255^2 before it is folded.
+static void flush_col_sse(const ssim_plane *plane, VPXT_SSIM_BAND *band,
+                          int row, int sse_end)
+{
+    const VPXT_FRAME_METRICS *metrics = plane->metrics;
+    int segments = plane->plane_index == 0 && metrics->run_artifact;
+    int x, j;
 
-        temp = y % 9 * width;
+    if (row != sse_end - 1 &&
+        (!segments || (row + 1) % metrics->segment_height))
+        return;
 
-        img1_sum_ptr2      = img1_sum + temp;
-        img2_sum_ptr2      = img2_sum + temp;
-        img1_sq_sum_ptr2   = img1_sq_sum + temp;
-        img2_sq_sum_ptr2   = img2_sq_sum + temp;
-        img12_mul_sum_ptr2 = img12_mul_sum + temp;
+    if (segments)
+    {
+        uint64_t *segment_row =
+            band->segment_sse[row / metrics->segment_height];
 
-        for (x = 0; x < width; x++)
+        for (j = 0; j * metrics->segment_width < plane->width; j++)
         {
-            img1_sum_ptr2[x]      = img1_sum_ptr1[x] + img1[x];
-            img2_sum_ptr2[x]      = img2_sum_ptr1[x] + img2[x];
-            img1_sq_sum_ptr2[x]   = img1_sq_sum_ptr1[x] + img1[x] * img1[x];
-            img2_sq_sum_ptr2[x]   = img2_sq_sum_ptr1[x] + img2[x] * img2[x];
-            img12_mul_sum_ptr2[x] = img12_mul_sum_ptr1[x] + img1[x] * img2[x];
+            int col = j * metrics->segment_width;
+            int end = col + metrics->segment_width;
+            uint64_t segment = 0;
+
+            if (end > plane->width)
+                end = plane->width;
+
+            for (x = col; x < end; x++)
+                segment += (unsigned int)band->col_sse[x];
+
+            segment_row[j] += segment;
+            band->sse += segment;
         }
+    }
+    else
+    {
+        for (x = 0; x < plane->width; x++)
+            band->sse += (unsigned int)band->col_sse[x];
+    }
+
+    memset(band->col_sse, 0, plane->width * sizeof(int));
+}
+
+// Measures the 8x8 windows whose top rows are in [first_row, last_row).
+// Column sums over the 8 rows under the window are kept per band and slid
+// down one row at a time, then each row of windows is summed by sliding
+// across those column sums.  Windows are accumulated in the same order as a
+// single pass over the plane so one band reproduces the scalar result.
+//
+// With metrics set, the squared error of each row below sse_end is taken
+// while the row is in cache from the column sum update.
+static void ssim_band(const ssim_plane *plane, VPXT_SSIM_BAND *band,
+                      int first_row, int last_row, int sse_end)
+{
+    VPXT_SSIM_CTX *ctx = plane->ctx;
+    const unsigned char *img1 = plane->img1;
+    const unsigned char *img2 = plane->img2;
+    const int stride_img1 = plane->stride_img1;
+    const int stride_img2 = plane->stride_img2;
+    const int width = plane->width;
+    const int windows = width - 7;
+    const int width_uv = ctx->width_uv;
+    short *img12_sum_block = ctx->img12_sum_block;
+    int x, y2, x2;
+    double weight, mean;
+
+    band->quality = 0;
+    band->summed_weights = 0;
+
+    if (plane->metrics)
+    {
+        band->sse = 0;
+        memset(band->segment_sse, 0, sizeof(band->segment_sse));
+        memset(band->col_sse, 0, width * sizeof(int));
+    }
 
-        if (y > 6)
+    memset(band->img1_sum, 0, width * sizeof(short));
+    memset(band->img2_sum, 0, width * sizeof(short));
+    memset(band->img1_sq_sum, 0, width * sizeof(int));
+    memset(band->img2_sq_sum, 0, width * sizeof(int));
+    memset(band->img12_mul_sum, 0, width * sizeof(int));
+
+    for (y2 = first_row; y2 < first_row + 8; y2++)
+    {
+        int measure = plane->metrics && y2 < sse_end;
+
+        plane->col_update(img1 + y2 * stride_img1, img2 + y2 * stride_img2,
+                          ctx->zero_row, ctx->zero_row, band,
+                          measure ? band->col_sse : NULL, width);
+
+        if (measure)
+            flush_col_sse(plane, band, y2, sse_end);
+    }
+
+    for (y2 = first_row; y2 < last_row; y2++)
+    {
+        int img1_block, img2_block, img1_sq_block, img2_sq_block;
+        int img12_mul_block;
+
+        if (y2 > first_row)
         {
-            //calculate the sum of the last 8 lines by subtracting the total sum of 8 lines back from the present sum
-            temp = (y + 1) % 9 * width;
+            int measure = plane->metrics && y2 + 7 < sse_end;
 
-            img1_sum_ptr1      = img1_sum + temp;
-            img2_sum_ptr1      = img2_sum + temp;
-            img1_sq_sum_ptr1   = img1_sq_sum + temp;
-            img2_sq_sum_ptr1   = img2_sq_sum + temp;
-            img12_mul_sum_ptr1 = img12_mul_sum + temp;
+            plane->col_update(img1 + (y2 + 7) * stride_img1,
+                              img2 + (y2 + 7) * stride_img2,
+                              img1 + (y2 - 1) * stride_img1,
+                              img2 + (y2 - 1) * stride_img2, band,
+                              measure ? band->col_sse : NULL, width);
 
-            for (x = 0; x < width; x++)
-            {
-                img1_sum_ptr1[x]      = img1_sum_ptr2[x] - img1_sum_ptr1[x];
-                img2_sum_ptr1[x]      = img2_sum_ptr2[x] - img2_sum_ptr1[x];
-                img1_sq_sum_ptr1[x]   = img1_sq_sum_ptr2[x] - img1_sq_sum_ptr1[x];
-                img2_sq_sum_ptr1[x]   = img2_sq_sum_ptr2[x] - img2_sq_sum_ptr1[x];
-                img12_mul_sum_ptr1[x] = img12_mul_sum_ptr2[x] - img12_mul_sum_ptr1[x];
-            }
+            if (measure)
+                flush_col_sse(plane, band, y2 + 7, sse_end);
+        }
+
+        //here we calculate the sum over the 8x8 block of pixels
+        //this is done by sliding a window across the column sums for the last 8 lines
+        //each time adding the new column sum, and subtracting the one which fell out of the window
+        img1_block      = 0;
+        img2_block      = 0;
+        img1_sq_block   = 0;
+        img2_sq_block   = 0;
+        img12_mul_block = 0;
+
+        for (x = 0; x < 8; x++)
+        {
+            img1_block      += band->img1_sum[x];
+            img2_block      += band->img2_sum[x];
+            img1_sq_block   += band->img1_sq_sum[x];
+            img2_sq_block   += band->img2_sq_sum[x];
+            img12_mul_block += band->img12_mul_sum[x];
+        }
 
-            //here we calculate the sum over the 8x8 block of pixels
-            //this is done by sliding a window across the column sums for the last 8 lines
-            //each time adding the new column sum, and subtracting the one which fell out of the window
-            img1_block      = 0;
-            img2_block      = 0;
-            img1_sq_block   = 0;
-            img2_sq_block   = 0;
-            img12_mul_block = 0;
-
-            //prologue, and calculation of simularity measure from the first 8 column sums
-            for (x = 0; x < 8; x++)
+        for (x2 = 0; x2 < windows; x2++)
+        {
+            if (x2)
             {
-                img1_block      += img1_sum_ptr1[x];
-                img2_block      += img2_sum_ptr1[x];
-                img1_sq_block   += img1_sq_sum_ptr1[x];
-                img2_sq_block   += img2_sq_sum_ptr1[x];
-                img12_mul_block += img12_mul_sum_ptr1[x];
+                x = x2 + 7;
+                img1_block      += band->img1_sum[x] - band->img1_sum[x - 8];
+                img2_block      += band->img2_sum[x] - band->img2_sum[x - 8];
+                img1_sq_block   += band->img1_sq_sum[x] - band->img1_sq_sum[x - 8];
+                img2_sq_block   += band->img2_sq_sum[x] - band->img2_sq_sum[x - 8];
+                img12_mul_block += band->img12_mul_sum[x] - band->img12_mul_sum[x - 8];
             }
 
-            if (lumimask)
+            band->block1[x2]  = img1_block;
+            band->block2[x2]  = img2_block;
+            band->block11[x2] = img1_sq_block;
+            band->block22[x2] = img2_sq_block;
+            band->block12[x2] = img12_mul_block;
+        }
+
+        plane->similarity(band, windows);
+
+        if (!ctx->lumimask)
+        {
+            for (x2 = 0; x2 < windows; x2++)
+                band->quality += band->similarity[x2];
+
+            continue;
+        }
+
+        for (x2 = 0; x2 < windows; x2++)
+        {
+            if (ctx->luminance)
             {
-                y2 = y - 7;
-                x2 = 0;
-
-                if (luminance)
-                {
-                    mean = (img2_block + img1_block) / 128.0f;
-
-                    if (!(y2 % 2 || x2 % 2))
-                        *(img12_sum_block + y2 / 2 * width_uv + x2 / 2) = img2_block + img1_block;
-                }
-                else
-                {
-                    mean = *(img12_sum_block + y2 * width_uv + x2);
-                    mean += *(img12_sum_block + y2 * width_uv + x2 + 4);
-                    mean += *(img12_sum_block + (y2 + 4) * width_uv + x2);
-                    mean += *(img12_sum_block + (y2 + 4) * width_uv + x2 + 4);
-
-                    mean /= 512.0f;
-                }
-
-                weight = mean < 40 ? 0.0f :
-                         (mean < 50 ? (mean - 40.0f) / 10.0f : 1.0f);
-                plane_summed_weights += weight;
-
-                plane_quality += weight * vp8_similarity(img1_block, img2_block, img1_sq_block, img2_sq_block, img12_mul_block);
+                int block_sum = band->block1[x2] + band->block2[x2];
+
+                mean = block_sum / 128.0f;
+
+                if (!(y2 % 2 || x2 % 2))
+                    *(img12_sum_block + y2 / 2 * width_uv + x2 / 2) = block_sum;
             }
             else
-                plane_quality += vp8_similarity(img1_block, img2_block, img1_sq_block, img2_sq_block, img12_mul_block);
+            {
+                mean = *(img12_sum_block + y2 * width_uv + x2);
+                mean += *(img12_sum_block + y2 * width_uv + x2 + 4);
+                mean += *(img12_sum_block + (y2 + 4) * width_uv + x2);
+                mean += *(img12_sum_block + (y2 + 4) * width_uv + x2 + 4);
+
+                mean /= 512.0f;
+            }
+
+            weight = mean < 40 ? 0.0f :
+                     (mean < 50 ? (mean - 40.0f) / 10.0f : 1.0f);
+            band->summed_weights += weight;
+
+            band->quality += weight * band->similarity[x2];
+        }
+    }
+}
+
+static void band_rows(const ssim_plane *plane, int band, int *first_row,
+                      int *last_row)
+{
+    *first_row = (int)((int64_t)plane->rows * band / plane->band_count);
+    *last_row = (int)((int64_t)plane->rows * (band + 1) / plane->band_count);
+}
+
+static void ssim_band_job(void *arg, int job)
+{
+    const ssim_plane *plane = (const ssim_plane *)arg;
+    int first_row, last_row;
+
+    band_rows(plane, job, &first_row, &last_row);
+
+    // each band owns the rows down to the next band, the last one owns the
+    // rows below its final windows as well
+    ssim_band(plane, &plane->ctx->bands[job], first_row, last_row,
+              job == plane->band_count - 1 ? plane->height : last_row);
+}
+
+static void ssimg_vertical_c(const unsigned char *org, const unsigned char *rec,
+                             int stride1, int stride2, VPXT_SSIM_BAND *band,
+                             int width);
+#if defined(HAS_SSIM_SSE2)
+static void ssimg_vertical_sse2(const unsigned char *org,
+                                const unsigned char *rec,
+                                int stride1, int stride2,
+                                VPXT_SSIM_BAND *band, int width);
+#endif
+#if defined(HAS_SSIM_NEON)
+static void ssimg_vertical_neon(const unsigned char *org,
+                                const unsigned char *rec,
+                                int stride1, int stride2,
+                                VPXT_SSIM_BAND *band, int width);
+#endif
+
+static void setup_plane(ssim_plane *plane, VPXT_SSIM_CTX *ctx,
+                        const unsigned char *img1, const unsigned char *img2,
+                        int stride_img1, int stride_img2, int width,
+                        int height, int rows)
+{
+    plane->ctx = ctx;
+    plane->img1 = img1;
+    plane->img2 = img2;
+    plane->stride_img1 = stride_img1;
+    plane->stride_img2 = stride_img2;
+    plane->width = width;
+    plane->height = height;
+    plane->rows = rows;
+    plane->band_count = rows / SSIM_MIN_BAND_ROWS;
+    plane->metrics = NULL;
+    plane->plane_index = 0;
+
+    if (plane->band_count > ctx->band_count)
+        plane->band_count = ctx->band_count;
+
+    if (plane->band_count < 1)
+        plane->band_count = 1;
+
+    plane->col_update = ssim_col_update_c;
+    plane->similarity = ssim_similarity_c;
+    plane->ssimg_vertical = ssimg_vertical_c;
+
+#if defined(HAS_SSIM_SSE2)
+    if (ctx->kernel_type == kSseKernelSSE2)
+    {
+        plane->col_update = ssim_col_update_sse2;
+        plane->similarity = ssim_similarity_sse2;
+        plane->ssimg_vertical = ssimg_vertical_sse2;
+    }
+#endif
+#if defined(HAS_SSIM_NEON)
+    if (ctx->kernel_type == kSseKernelNEON)
+    {
+        plane->col_update = ssim_col_update_neon;
+        plane->ssimg_vertical = ssimg_vertical_neon;
+    }
+#endif
+}
+
+static void run_bands(ssim_plane *plane, vpxt_job_fn_t job)
+{
+    int i;
 
-            //and for the rest
-            for (x = 8; x < width; x++)
+    if (plane->band_count > 1 && plane->ctx->pool)
+        vpxt_pool_run(plane->ctx->pool, job, plane, plane->band_count);
+    else
+        for (i = 0; i < plane->band_count; i++)
+            job(plane, i);
+}
+
+static double measure_plane
+(
+    VPXT_SSIM_CTX *ctx,
+    const unsigned char *img1,
+    const unsigned char *img2,
+    int stride_img1,
+    int stride_img2,
+    int width,
+    int height,
+    VPXT_FRAME_METRICS *metrics,
+    int plane_index
+)
+{
+    ssim_plane plane;
+    double plane_quality;
+    int i, j, k;
+
+    plane_quality = 0;
+
+    if (ctx->lumimask)
+        ctx->plane_summed_weights = 0.0f;
+    else
+        ctx->plane_summed_weights = (height - 7) * (width - 7);
+
+    setup_plane(&plane, ctx, img1, img2, stride_img1, stride_img2, width,
+                height, height - 7);
+    plane.metrics = metrics;
+    plane.plane_index = plane_index;
+
+    if (width >= 8 && height >= 8)
+    {
+        run_bands(&plane, ssim_band_job);
+
+        for (i = 0; i < plane.band_count; i++)
+        {
+            plane_quality += ctx->bands[i].quality;
+
+            if (ctx->lumimask)
+                ctx->plane_summed_weights += ctx->bands[i].summed_weights;
+        }
+    }
+
+    if (metrics)
+    {
+        metrics->sse[plane_index] = 0;
+
+        if (width >= 8 && height >= 8)
+        {
+            for (i = 0; i < plane.band_count; i++)
             {
-                img1_block      = img1_block + img1_sum_ptr1[x] - img1_sum_ptr1[x - 8];
-                img2_block      = img2_block + img2_sum_ptr1[x] - img2_sum_ptr1[x - 8];
-                img1_sq_block   = img1_sq_block + img1_sq_sum_ptr1[x] - img1_sq_sum_ptr1[x - 8];
-                img2_sq_block   = img2_sq_block + img2_sq_sum_ptr1[x] - img2_sq_sum_ptr1[x - 8];
-                img12_mul_block = img12_mul_block + img12_mul_sum_ptr1[x] - img12_mul_sum_ptr1[x - 8];
-
-                if (lumimask)
-                {
-                    y2 = y - 7;
-                    x2 = x - 7;
-
-                    if (luminance)
-                    {
-                        mean = (img2_block + img1_block) / 128.0f;
-
-                        if (!(y2 % 2 || x2 % 2))
-                            *(img12_sum_block + y2 / 2 * width_uv + x2 / 2) = img2_block + img1_block;
-                    }
-                    else
-                    {
-                        mean = *(img12_sum_block + y2 * width_uv + x2);
-                        mean += *(img12_sum_block + y2 * width_uv + x2 + 4);
-                        mean += *(img12_sum_block + (y2 + 4) * width_uv + x2);
-                        mean += *(img12_sum_block + (y2 + 4) * width_uv + x2 + 4);
-
-                        mean /= 512.0f;
-                    }
-
-                    weight = mean < 40 ? 0.0f :
-                             (mean < 50 ? (mean - 40.0f) / 10.0f : 1.0f);
-                    plane_summed_weights += weight;
-
-                    plane_quality += weight * vp8_similarity(img1_block, img2_block, img1_sq_block, img2_sq_block, img12_mul_block);
-                }
-                else
-                    plane_quality += vp8_similarity(img1_block, img2_block, img1_sq_block, img2_sq_block, img12_mul_block);
+                const VPXT_SSIM_BAND *band = &ctx->bands[i];
+
+                metrics->sse[plane_index] += band->sse;
+
+                if (plane_index == 0 && metrics->run_artifact)
+                    for (j = 0; j < VPXT_MAX_SEGMENTS; j++)
+                        for (k = 0; k < VPXT_MAX_SEGMENTS; k++)
+                            metrics->segment_sse[j][k] +=
+                                band->segment_sse[j][k];
             }
         }
+        else
+        {
+            ctx->bands[0].sse = 0;
+            memset(ctx->bands[0].segment_sse, 0,
+                   sizeof(ctx->bands[0].segment_sse));
+
+            for (i = 0; i < height; i++)
+                ssim_row_sse(&plane, &ctx->bands[0], i);
+
+            metrics->sse[plane_index] = ctx->bands[0].sse;
+
+            if (plane_index == 0 && metrics->run_artifact)
+                memcpy(metrics->segment_sse, ctx->bands[0].segment_sse,
+                       sizeof(metrics->segment_sse));
+        }
     }
 
-    if (plane_summed_weights == 0)
+    if (ctx->plane_summed_weights == 0)
         return 1.0f;
     else
-        return plane_quality / plane_summed_weights;
+        return plane_quality / ctx->plane_summed_weights;
 }
 
-double VP8_CalcSSIM_Tester
+double vp8_ssim
 (
+    VPXT_SSIM_CTX *ctx,
+    const unsigned char *img1,
+    const unsigned char *img2,
+    int stride_img1,
+    int stride_img2,
+    int width,
+    int height
+)
+{
+    return measure_plane(ctx, img1, img2, stride_img1, stride_img2, width,
+                         height, NULL, 0);
+}
+
+// SSIM of a frame, optionally gathering squared error into metrics as the
+// planes are read.  The context must already be sized for the frame.
+static double calc_ssim_planes
+(
+    VPXT_SSIM_CTX *ctx,
     YV12_BUFFER_CONFIG *source,
     YV12_BUFFER_CONFIG *dest,
     int lumamask,
-    double *weight
+    double *weight,
+    VPXT_FRAME_METRICS *metrics
 )
 {
     double a, b, c;
     double frame_weight;
     double ssimv;
 
-    width_y = source->y_width;
-    height_y = source->y_height;
-    height_uv = source->uv_height;
-    width_uv = source->uv_width;
-    stride_uv = dest->uv_stride;
-    stride = dest->y_stride;
-
-    lumimask = lumamask;
+    ctx->lumimask = lumamask;
 
-    luminance = 1;
-    a = vp8_ssim(source->y_buffer, dest->y_buffer,
-                 source->y_stride, dest->y_stride, source->y_width, source->y_height);
-    luminance = 0;
+    ctx->luminance = 1;
+    a = measure_plane(ctx, source->y_buffer, dest->y_buffer,
+                      source->y_stride, dest->y_stride, source->y_width,
+                      source->y_height, metrics, 0);
+    ctx->luminance = 0;
 
-    frame_weight = plane_summed_weights / ((width_y - 7) * (height_y - 7));
+    frame_weight = ctx->plane_summed_weights / ((source->y_width - 7) * (source->y_height - 7));
 
     if (frame_weight == 0)
+    {
         a = b = c = 1.0f;
+
+        if (metrics)
+        {
+            metrics->sse[1] = vpxt_sse(source->u_buffer, source->uv_stride,
+                dest->u_buffer, dest->uv_stride, source->uv_width,
+                source->uv_height);
+            metrics->sse[2] = vpxt_sse(source->v_buffer, source->uv_stride,
+                dest->v_buffer, dest->uv_stride, source->uv_width,
+                source->uv_height);
+        }
+    }
     else
     {
-        b = vp8_ssim(source->u_buffer, dest->u_buffer,
-                     source->uv_stride, dest->uv_stride, source->uv_width, source->uv_height);
+        b = measure_plane(ctx, source->u_buffer, dest->u_buffer,
+                          source->uv_stride, dest->uv_stride,
+                          source->uv_width, source->uv_height, metrics, 1);
 
-        c = vp8_ssim(source->v_buffer, dest->v_buffer,
-                     source->uv_stride, dest->uv_stride, source->uv_width, source->uv_height);
+        c = measure_plane(ctx, source->v_buffer, dest->v_buffer,
+                          source->uv_stride, dest->uv_stride,
+                          source->uv_width, source->uv_height, metrics, 2);
     }
 
     ssimv = a * .8 + .1 * (b + c);
@@ -303,6 +977,77 @@ double VP8_CalcSSIM_Tester
     return ssimv;
 }
 
+double vpxt_calc_ssim
+(
+    VPXT_SSIM_CTX *ctx,
+    YV12_BUFFER_CONFIG *source,
+    YV12_BUFFER_CONFIG *dest,
+    int lumamask,
+    double *weight
+)
+{
+    if (vpxt_ssim_ctx_alloc(ctx, source->y_width, source->y_height,
+                            source->uv_width, source->uv_height))
+    {
+        *weight = 0;
+        return 1.0f;
+    }
+
+    return calc_ssim_planes(ctx, source, dest, lumamask, weight, NULL);
+}
+
+void vpxt_calc_frame_metrics
+(
+    VPXT_SSIM_CTX *ctx,
+    YV12_BUFFER_CONFIG *source,
+    YV12_BUFFER_CONFIG *dest,
+    int run_ssim,
+    int run_artifact,
+    VPXT_FRAME_METRICS *metrics
+)
+{
+    vpxt_init_frame_metrics(source, run_artifact, metrics);
+
+    if (!run_ssim)
+    {
+        vpxt_frame_sse(source, dest, metrics);
+        return;
+    }
+
+    if (vpxt_ssim_ctx_alloc(ctx, source->y_width, source->y_height,
+                            source->uv_width, source->uv_height))
+    {
+        metrics->ssim = 1.0f;
+        metrics->ssim_weight = 0;
+        vpxt_frame_sse(source, dest, metrics);
+        return;
+    }
+
+    metrics->ssim = calc_ssim_planes(ctx, source, dest, 1,
+                                     &metrics->ssim_weight, metrics);
+}
+
+// Reentrant wrapper that sizes a context for this frame only.  Callers that
+// compute SSIM on many frames should keep a VPXT_SSIM_CTX and call
+// vpxt_calc_ssim instead.
+double VP8_CalcSSIM_Tester
+(
+    YV12_BUFFER_CONFIG *source,
+    YV12_BUFFER_CONFIG *dest,
+    int lumamask,
+    double *weight
+)
+{
+    VPXT_SSIM_CTX ctx;
+    double ssimv;
+
+    vpxt_ssim_ctx_init(&ctx);
+    ssimv = vpxt_calc_ssim(&ctx, source, dest, lumamask, weight);
+    vpxt_ssim_ctx_free(&ctx);
+
+    return ssimv;
+}
+
 // Google version of SSIM
 // SSIM
 #define KERNEL 3
@@ -381,6 +1126,34 @@ double get_ssimg(const uint8 *org, const uint8 *rec,
 
 }
 
+// SSIM of one pixel from the sums of the full 7x7 gaussian window.
+static double ssimg_from_sums(uint32 xm, uint32 ym, uint32 xxm, uint32 xym,
+                              uint32 yym)
+{
+    const double iw = ki_w;
+    const double iwx = xm * iw;
+    const double iwy = ym * iw;
+    double sxx = xxm * iw - iwx * iwx;
+    double syy = yym * iw - iwy * iwy;
+
+    // small errors are possible, due to rounding. Clamp to zero.
+    if (sxx < 0.) sxx = 0.;
+
+    if (syy < 0.) syy = 0.;
+
+    {
+        const double sxsy = sqrt(sxx * syy);
+        const double sxy = xym * iw - iwx * iwy;
+        static const double C11 = (0.01 * 0.01) * (255 * 255);
+        static const double C22 = (0.03 * 0.03) * (255 * 255);
+        static const double C33 = (0.015 * 0.015) * (255 * 255);
+        const double l = (2. * iwx * iwy + C11) / (iwx * iwx + iwy * iwy + C11);
+        const double c = (2. * sxsy      + C22) / (sxx + syy + C22);
+        const double s = (sxy + C33) / (sxsy + C33);
+        return l * c * s;
+    }
+}
+
 double get_ssimfull_kernelg(const uint8 *org, const uint8 *rec,
                             int xo, int yo, int W, int H,
                             const int stride1, const int stride2)
@@ -414,30 +1187,7 @@ double get_ssimfull_kernelg(const uint8 *org, const uint8 *rec,
         }
     }
 
-    {
-        const double iw = ki_w;
-        const double iwx = xm * iw;
-        const double iwy = ym * iw;
-        double sxx = xxm * iw - iwx * iwx;
-        double syy = yym * iw - iwy * iwy;
-
-        // small errors are possible, due to rounding. Clamp to zero.
-        if (sxx < 0.) sxx = 0.;
-
-        if (syy < 0.) syy = 0.;
-
-        {
-            const double sxsy = sqrt(sxx * syy);
-            const double sxy = xym * iw - iwx * iwy;
-            static const double C11 = (0.01 * 0.01) * (255 * 255);
-            static const double C22 = (0.03 * 0.03) * (255 * 255);
-            static const double C33 = (0.015 * 0.015) * (255 * 255);
-            const double l = (2. * iwx * iwy + C11) / (iwx * iwx + iwy * iwy + C11);
-            const double c = (2. * sxsy      + C22) / (sxx + syy + C22);
-            const double s = (sxy + C33) / (sxsy + C33);
-            return l * c * s;
-        }
-    }
+    return ssimg_from_sums(xm, ym, xxm, xym, yym);
 }
 
 double calc_ssimg(const uint8 *org, const uint8 *rec,
@@ -520,3 +1270,346 @@ double vp8_calc_ssimg
     *ssim_v /= uvsize;
     return ssim_all;
 }
+
+static void ssimg_vertical_c(const unsigned char *org, const unsigned char *rec,
+                             int stride1, int stride2, VPXT_SSIM_BAND *band,
+                             int width)
+{
+    int x, y_;
+
+    for (x = 0; x < width; x++)
+    {
+        uint32 xm = 0, ym = 0, xxm = 0, xym = 0, yym = 0;
+
+        for (y_ = 0; y_ < KERNEL_SIZE; ++y_)
+        {
+            const int Wy = K[y_];
+            const int org_x = org[y_ * stride1 + x];
+            const int rec_x = rec[y_ * stride2 + x];
+            xm  += Wy * org_x;
+            ym  += Wy * rec_x;
+            xxm += Wy * org_x * org_x;
+            xym += Wy * org_x * rec_x;
+            yym += Wy * rec_x * rec_x;
+        }
+
+        band->block1[x]  = xm;
+        band->block2[x]  = ym;
+        band->block11[x] = xxm;
+        band->block12[x] = xym;
+        band->block22[x] = yym;
+    }
+}
+
+#if defined(HAS_SSIM_SSE2)
+VPXT_TARGET("sse2")
+static void ssimg_vertical_sse2(const unsigned char *org,
+                                const unsigned char *rec,
+                                int stride1, int stride2,
+                                VPXT_SSIM_BAND *band, int width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x, y_;
+
+    for (x = 0; x + 8 <= width; x += 8)
+    {
+        __m128i xm[2], ym[2], xxm[2], xym[2], yym[2];
+        int i;
+
+        for (i = 0; i < 2; i++)
+            xm[i] = ym[i] = xxm[i] = xym[i] = yym[i] = zero;
+
+        // two rows at a time; madd adds the weighted products of the pair
+        for (y_ = 0; y_ < KERNEL_SIZE; y_ += 2)
+        {
+            const int ka = K[y_];
+            const int kb = y_ + 1 < KERNEL_SIZE ? K[y_ + 1] : 0;
+            const __m128i weights = _mm_set_epi16(kb, ka, kb, ka, kb, ka,
+                                                  kb, ka);
+            const __m128i pa = _mm_unpacklo_epi8(_mm_loadl_epi64(
+                (const __m128i *)(org + y_ * stride1 + x)), zero);
+            const __m128i qa = _mm_unpacklo_epi8(_mm_loadl_epi64(
+                (const __m128i *)(rec + y_ * stride2 + x)), zero);
+            const __m128i pb = kb ? _mm_unpacklo_epi8(_mm_loadl_epi64(
+                (const __m128i *)(org + (y_ + 1) * stride1 + x)), zero) : zero;
+            const __m128i qb = kb ? _mm_unpacklo_epi8(_mm_loadl_epi64(
+                (const __m128i *)(rec + (y_ + 1) * stride2 + x)), zero) : zero;
+            const __m128i kpa = _mm_mullo_epi16(pa, _mm_set1_epi16(ka));
+            const __m128i kqa = _mm_mullo_epi16(qa, _mm_set1_epi16(ka));
+            const __m128i kpb = _mm_mullo_epi16(pb, _mm_set1_epi16(kb));
+            const __m128i kqb = _mm_mullo_epi16(qb, _mm_set1_epi16(kb));
+            __m128i p[2], q[2], kp[2], kq[2];
+
+            p[0] = _mm_unpacklo_epi16(pa, pb);
+            p[1] = _mm_unpackhi_epi16(pa, pb);
+            q[0] = _mm_unpacklo_epi16(qa, qb);
+            q[1] = _mm_unpackhi_epi16(qa, qb);
+            kp[0] = _mm_unpacklo_epi16(kpa, kpb);
+            kp[1] = _mm_unpackhi_epi16(kpa, kpb);
+            kq[0] = _mm_unpacklo_epi16(kqa, kqb);
+            kq[1] = _mm_unpackhi_epi16(kqa, kqb);
+
+            for (i = 0; i < 2; i++)
+            {
+                xm[i] = _mm_add_epi32(xm[i], _mm_madd_epi16(p[i], weights));
+                ym[i] = _mm_add_epi32(ym[i], _mm_madd_epi16(q[i], weights));
+                xxm[i] = _mm_add_epi32(xxm[i], _mm_madd_epi16(p[i], kp[i]));
+                xym[i] = _mm_add_epi32(xym[i], _mm_madd_epi16(p[i], kq[i]));
+                yym[i] = _mm_add_epi32(yym[i], _mm_madd_epi16(q[i], kq[i]));
+            }
+        }
+
+        for (i = 0; i < 2; i++)
+        {
+            _mm_storeu_si128((__m128i *)(band->block1 + x + 4 * i), xm[i]);
+            _mm_storeu_si128((__m128i *)(band->block2 + x + 4 * i), ym[i]);
+            _mm_storeu_si128((__m128i *)(band->block11 + x + 4 * i), xxm[i]);
+            _mm_storeu_si128((__m128i *)(band->block12 + x + 4 * i), xym[i]);
+            _mm_storeu_si128((__m128i *)(band->block22 + x + 4 * i), yym[i]);
+        }
+    }
+
+    for (; x < width; x++)
+    {
+        uint32 xm = 0, ym = 0, xxm = 0, xym = 0, yym = 0;
+
+        for (y_ = 0; y_ < KERNEL_SIZE; ++y_)
+        {
+            const int Wy = K[y_];
+            const int org_x = org[y_ * stride1 + x];
+            const int rec_x = rec[y_ * stride2 + x];
+            xm  += Wy * org_x;
+            ym  += Wy * rec_x;
+            xxm += Wy * org_x * org_x;
+            xym += Wy * org_x * rec_x;
+            yym += Wy * rec_x * rec_x;
+        }
+
+        band->block1[x]  = xm;
+        band->block2[x]  = ym;
+        band->block11[x] = xxm;
+        band->block12[x] = xym;
+        band->block22[x] = yym;
+    }
+}
+#endif
+
+#if defined(HAS_SSIM_NEON)
+static void ssimg_vertical_neon(const unsigned char *org,
+                                const unsigned char *rec,
+                                int stride1, int stride2,
+                                VPXT_SSIM_BAND *band, int width)
+{
+    int x, y_;
+
+    for (x = 0; x + 8 <= width; x += 8)
+    {
+        uint32x4_t xm_lo = vdupq_n_u32(0), xm_hi = vdupq_n_u32(0);
+        uint32x4_t ym_lo = vdupq_n_u32(0), ym_hi = vdupq_n_u32(0);
+        uint32x4_t xxm_lo = vdupq_n_u32(0), xxm_hi = vdupq_n_u32(0);
+        uint32x4_t xym_lo = vdupq_n_u32(0), xym_hi = vdupq_n_u32(0);
+        uint32x4_t yym_lo = vdupq_n_u32(0), yym_hi = vdupq_n_u32(0);
+
+        for (y_ = 0; y_ < KERNEL_SIZE; ++y_)
+        {
+            const uint16_t k = (uint16_t)K[y_];
+            const uint16x8_t o = vmovl_u8(vld1_u8(org + y_ * stride1 + x));
+            const uint16x8_t r = vmovl_u8(vld1_u8(rec + y_ * stride2 + x));
+            const uint16x8_t ko = vmulq_n_u16(o, k);
+            const uint16x8_t kr = vmulq_n_u16(r, k);
+
+            xm_lo = vmlal_n_u16(xm_lo, vget_low_u16(o), k);
+            xm_hi = vmlal_n_u16(xm_hi, vget_high_u16(o), k);
+            ym_lo = vmlal_n_u16(ym_lo, vget_low_u16(r), k);
+            ym_hi = vmlal_n_u16(ym_hi, vget_high_u16(r), k);
+            xxm_lo = vmlal_u16(xxm_lo, vget_low_u16(o), vget_low_u16(ko));
+            xxm_hi = vmlal_u16(xxm_hi, vget_high_u16(o), vget_high_u16(ko));
+            xym_lo = vmlal_u16(xym_lo, vget_low_u16(o), vget_low_u16(kr));
+            xym_hi = vmlal_u16(xym_hi, vget_high_u16(o), vget_high_u16(kr));
+            yym_lo = vmlal_u16(yym_lo, vget_low_u16(r), vget_low_u16(kr));
+            yym_hi = vmlal_u16(yym_hi, vget_high_u16(r), vget_high_u16(kr));
+        }
+
+        vst1q_u32((uint32_t *)band->block1 + x, xm_lo);
+        vst1q_u32((uint32_t *)band->block1 + x + 4, xm_hi);
+        vst1q_u32((uint32_t *)band->block2 + x, ym_lo);
+        vst1q_u32((uint32_t *)band->block2 + x + 4, ym_hi);
+        vst1q_u32((uint32_t *)band->block11 + x, xxm_lo);
+        vst1q_u32((uint32_t *)band->block11 + x + 4, xxm_hi);
+        vst1q_u32((uint32_t *)band->block12 + x, xym_lo);
+        vst1q_u32((uint32_t *)band->block12 + x + 4, xym_hi);
+        vst1q_u32((uint32_t *)band->block22 + x, yym_lo);
+        vst1q_u32((uint32_t *)band->block22 + x + 4, yym_hi);
+    }
+
+    for (; x < width; x++)
+    {
+        uint32 xm = 0, ym = 0, xxm = 0, xym = 0, yym = 0;
+
+        for (y_ = 0; y_ < KERNEL_SIZE; ++y_)
+        {
+            const int Wy = K[y_];
+            const int org_x = org[y_ * stride1 + x];
+            const int rec_x = rec[y_ * stride2 + x];
+            xm  += Wy * org_x;
+            ym  += Wy * rec_x;
+            xxm += Wy * org_x * org_x;
+            xym += Wy * org_x * rec_x;
+            yym += Wy * rec_x * rec_x;
+        }
+
+        band->block1[x]  = xm;
+        band->block2[x]  = ym;
+        band->block11[x] = xxm;
+        band->block12[x] = xym;
+        band->block22[x] = yym;
+    }
+}
+#endif
+
+// get_ssimfull_kernelg for the pixel at column xo, built from the weighted
+// 7 row column sums left in the band by the vertical pass.
+static double ssimg_full_kernel_from_columns(const VPXT_SSIM_BAND *band,
+                                             int xo)
+{
+    int x_;
+    uint32 xm = 0, ym = 0, xxm = 0, xym = 0, yym = 0;
+
+    for (x_ = 0; x_ < KERNEL_SIZE; ++x_)
+    {
+        const uint32 Wx = K[x_];
+        const int col = xo - KERNEL + x_;
+        xm  += Wx * (uint32)band->block1[col];
+        ym  += Wx * (uint32)band->block2[col];
+        xxm += Wx * (uint32)band->block11[col];
+        xym += Wx * (uint32)band->block12[col];
+        yym += Wx * (uint32)band->block22[col];
+    }
+
+    return ssimg_from_sums(xm, ym, xxm, xym, yym);
+}
+
+// Rows are visited in the same order as calc_ssimg so a single band
+// reproduces its result.
+static void ssimg_band(const ssim_plane *plane, VPXT_SSIM_BAND *band,
+                       int first_row, int last_row)
+{
+    const uint8 *org = plane->img1;
+    const uint8 *rec = plane->img2;
+    const int stride1 = plane->stride_img1;
+    const int stride2 = plane->stride_img2;
+    const int image_width = plane->width;
+    const int image_height = plane->height;
+    double SSIM = 0.;
+    int j, i;
+
+    for (j = first_row; j < last_row; ++j)
+    {
+        if (j < KERNEL || j >= image_height - KERNEL)
+        {
+            for (i = 0; i < image_width; ++i)
+            {
+                SSIM += get_ssimg(org, rec, i, j, image_width, image_height, stride1, stride2);
+            }
+
+            continue;
+        }
+
+        for (i = 0; i < KERNEL; ++i)
+        {
+            SSIM += get_ssimg(org, rec, i, j, image_width, image_height, stride1, stride2);
+        }
+
+        if (image_width > 2 * KERNEL)
+        {
+            plane->ssimg_vertical(org + (j - KERNEL) * stride1,
+                                  rec + (j - KERNEL) * stride2,
+                                  stride1, stride2, band, image_width);
+
+            for (i = KERNEL; i < image_width - KERNEL; ++i)
+            {
+                SSIM += ssimg_full_kernel_from_columns(band, i);
+            }
+        }
+
+        for (i = image_width - KERNEL; i < image_width; ++i)
+        {
+            SSIM += get_ssimg(org, rec, i, j, image_width, image_height, stride1, stride2);
+        }
+    }
+
+    band->quality = SSIM;
+}
+
+static void ssimg_band_job(void *arg, int job)
+{
+    const ssim_plane *plane = (const ssim_plane *)arg;
+    int first_row, last_row;
+
+    band_rows(plane, job, &first_row, &last_row);
+    ssimg_band(plane, &plane->ctx->bands[job], first_row, last_row);
+}
+
+static double ssimg_plane(VPXT_SSIM_CTX *ctx, const uint8 *org,
+                          const uint8 *rec, const int image_width,
+                          const int image_height, const int stride1,
+                          const int stride2)
+{
+    ssim_plane plane;
+    double SSIM = 0.;
+    int i;
+
+    // the border rows overlap on planes this small, leave them to the
+    // reference loop
+    if (image_height < 2 * KERNEL)
+        return calc_ssimg(org, rec, image_width, image_height, stride1,
+                          stride2);
+
+    setup_plane(&plane, ctx, org, rec, stride1, stride2, image_width,
+                image_height, image_height);
+    run_bands(&plane, ssimg_band_job);
+
+    for (i = 0; i < plane.band_count; i++)
+        SSIM += ctx->bands[i].quality;
+
+    return SSIM;
+}
+
+double vpxt_calc_ssimg
+(
+    VPXT_SSIM_CTX *ctx,
+    YV12_BUFFER_CONFIG *source,
+    YV12_BUFFER_CONFIG *dest,
+    double *ssim_y,
+    double *ssim_u,
+    double *ssim_v
+)
+{
+    double ssim_all = 0;
+    int ysize  = source->y_width * source->y_height;
+    int uvsize = ysize / 4;
+
+    if (vpxt_ssim_ctx_alloc(ctx, source->y_width, source->y_height,
+                            source->uv_width, source->uv_height))
+        return vp8_calc_ssimg(source, dest, ssim_y, ssim_u, ssim_v);
+
+    *ssim_y = ssimg_plane(ctx, source->y_buffer, dest->y_buffer,
+                          source->y_width, source->y_height,
+                          source->y_stride, dest->y_stride);
+
+
+    *ssim_u = ssimg_plane(ctx, source->u_buffer, dest->u_buffer,
+                          source->uv_width, source->uv_height,
+                          source->uv_stride, dest->uv_stride);
+
+
+    *ssim_v = ssimg_plane(ctx, source->v_buffer, dest->v_buffer,
+                          source->uv_width, source->uv_height,
+                          source->uv_stride, dest->uv_stride);
+
+    ssim_all = (*ssim_y + *ssim_u + *ssim_v) / (ysize + uvsize + uvsize);
+    *ssim_y /= ysize;
+    *ssim_u /= uvsize;
+    *ssim_v /= uvsize;
+    return ssim_all;
+}
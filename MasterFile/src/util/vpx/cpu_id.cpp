@@ -27,7 +27,7 @@ static inline void __cpuid(int cpu_info[4], int info_type) {
     "cpuid                                     \n"
     "xchg %%edi, %%ebx                         \n"
     : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type)
+    : "a"(info_type), "c"(0)
   );
 }
 #elif defined(__i386__) || defined(__x86_64__)
@@ -35,11 +35,31 @@ static inline void __cpuid(int cpu_info[4], int info_type) {
   asm volatile (
     "cpuid                                     \n"
     : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type)
+    : "a"(info_type), "c"(0)
   );
 }
 #endif
 
+// AVX2 needs leaf 7 of cpuid plus OS support for saving the ymm registers,
+// which is only reported through xgetbv.
+#if defined(_MSC_VER) && _MSC_VER >= 1700
+#define HAS_XGETBV
+static inline int GetXCR0() {
+  return (int)_xgetbv(0);
+}
+#elif defined(__i386__) || defined(__x86_64__)
+#define HAS_XGETBV
+static inline int GetXCR0() {
+  int xcr0_lo, xcr0_hi;
+  asm volatile (
+    ".byte 0x0f, 0x01, 0xd0                    \n"  // xgetbv
+    : "=a"(xcr0_lo), "=d"(xcr0_hi)
+    : "c"(0)
+  );
+  return xcr0_lo;
+}
+#endif
+
 #ifdef __cplusplus
 namespace libyuv {
 extern "C" {
@@ -55,6 +75,18 @@ int InitCpuFlags() {
   cpu_info_ = (cpu_info[3] & 0x04000000 ? kCpuHasSSE2 : 0) |
               (cpu_info[2] & 0x00000200 ? kCpuHasSSSE3 : 0) |
               kCpuInitialized;
+#ifdef HAS_XGETBV
+  // osxsave and avx set, and the os saves xmm and ymm state
+  if ((cpu_info[2] & 0x18000000) == 0x18000000 && (GetXCR0() & 6) == 6) {
+    int max_leaf = 0;
+    __cpuid(cpu_info, 0);
+    max_leaf = cpu_info[0];
+    if (max_leaf >= 7) {
+      __cpuid(cpu_info, 7);
+      cpu_info_ |= (cpu_info[1] & 0x00000020 ? kCpuHasAVX2 : 0);
+    }
+  }
+#endif
 #elif defined(__ANDROID__) && defined(__ARM_NEON__)
   uint64_t features = android_getCpuFeatures();
   cpu_info_ = ((features & ANDROID_CPU_ARM_FEATURE_NEON) ? kCpuHasNEON : 0) |
@@ -0,0 +1,281 @@
+#include "vpxt_benchmark.h"
+#include "vpxt_thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void bench_env_int(const char *name, int *value)
+{
+    const char *env = getenv(name);
+
+    if (env && *env)
+        *value = atoi(env);
+}
+
+static void bench_env_double(const char *name, double *value)
+{
+    const char *env = getenv(name);
+
+    if (env && *env)
+        *value = atof(env);
+}
+
+static int bench_compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+// Median of count values, sorts them in place.
+static double bench_median(double *values, int count)
+{
+    if (count < 1)
+        return 0;
+
+    qsort(values, count, sizeof(double), bench_compare_double);
+
+    if (count & 1)
+        return values[count / 2];
+
+    return (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+// Fixed seed so the same samples always give the same interval.
+static unsigned int bench_random(unsigned int *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+
+    return *state;
+}
+
+// Median of count values drawn with replacement from samples.
+static double bench_resample_median(const double *samples, int count,
+                                    double *scratch, unsigned int *state)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+        scratch[i] = samples[bench_random(state) % count];
+
+    return bench_median(scratch, count);
+}
+
+static int bench_resamples(const VPXT_BENCH_CONFIG *config)
+{
+    return config->resamples < 1 ? 1 : config->resamples;
+}
+
+// Lower and upper confidence bounds of count sorted estimates.
+static void bench_interval(const VPXT_BENCH_CONFIG *config,
+                           const double *estimates, int count,
+                           double *low, double *high)
+{
+    double tail = (1 - config->confidence) / 2;
+    int low_index = tail > 0 ? (int)(tail * count) : 0;
+
+    *low = estimates[low_index];
+    *high = estimates[count - 1 - low_index];
+}
+
+void vpxt_bench_config_init(VPXT_BENCH_CONFIG *config)
+{
+    config->warmup = VPXT_BENCH_WARMUP;
+    config->repetitions = VPXT_BENCH_REPETITIONS;
+    config->cpu = -1;
+    config->cpu_count = 1;
+    config->outlier = VPXT_BENCH_OUTLIER;
+    config->resamples = VPXT_BENCH_RESAMPLES;
+    config->confidence = VPXT_BENCH_CONFIDENCE;
+
+    bench_env_int("VPXT_BENCH_WARMUP", &config->warmup);
+    bench_env_int("VPXT_BENCH_REPETITIONS", &config->repetitions);
+    bench_env_int("VPXT_BENCH_CPU", &config->cpu);
+    bench_env_double("VPXT_BENCH_OUTLIER", &config->outlier);
+    bench_env_int("VPXT_BENCH_RESAMPLES", &config->resamples);
+    bench_env_double("VPXT_BENCH_CONFIDENCE", &config->confidence);
+
+    if (config->warmup < 0)
+        config->warmup = 0;
+
+    if (config->repetitions < 1)
+        config->repetitions = 1;
+
+    if (config->repetitions > VPXT_BENCH_MAX_SAMPLES)
+        config->repetitions = VPXT_BENCH_MAX_SAMPLES;
+
+    if (config->confidence <= 0 || config->confidence >= 1)
+        config->confidence = VPXT_BENCH_CONFIDENCE;
+}
+
+void vpxt_bench_clear(VPXT_BENCH_RESULT *result)
+{
+    memset(result, 0, sizeof(*result));
+}
+
+void vpxt_bench_add(VPXT_BENCH_RESULT *result, double sample)
+{
+    if (result->raw_count < VPXT_BENCH_MAX_SAMPLES)
+        result->raw[result->raw_count++] = sample;
+}
+
+void vpxt_bench_finish(const VPXT_BENCH_CONFIG *config,
+                       VPXT_BENCH_RESULT *result)
+{
+    double deviation[VPXT_BENCH_MAX_SAMPLES];
+    double scratch[VPXT_BENCH_MAX_SAMPLES];
+    double median;
+    double limit;
+    int resamples = bench_resamples(config);
+    double *estimates;
+    unsigned int state = 0x2545f491;
+    int i;
+
+    memcpy(result->samples, result->raw, result->raw_count * sizeof(double));
+    result->count = result->raw_count;
+    median = bench_median(result->samples, result->count);
+
+    // 1.4826 scales the median absolute deviation to a standard deviation
+    // for normally distributed samples
+    for (i = 0; i < result->count; i++)
+        deviation[i] = result->samples[i] > median ?
+            result->samples[i] - median : median - result->samples[i];
+
+    limit = config->outlier * 1.4826 * bench_median(deviation, result->count);
+
+    if (limit > 0)
+    {
+        int kept = 0;
+
+        for (i = 0; i < result->count; i++)
+            if (result->samples[i] >= median - limit &&
+                result->samples[i] <= median + limit)
+                result->samples[kept++] = result->samples[i];
+
+        result->count = kept;
+    }
+
+    result->median = bench_median(result->samples, result->count);
+    result->low = result->median;
+    result->high = result->median;
+
+    if (result->count < 2)
+        return;
+
+    estimates = (double *)malloc(resamples * sizeof(double));
+
+    if (!estimates)
+        return;
+
+    for (i = 0; i < resamples; i++)
+        estimates[i] = bench_resample_median(result->samples, result->count,
+            scratch, &state);
+
+    qsort(estimates, resamples, sizeof(double), bench_compare_double);
+    bench_interval(config, estimates, resamples, &result->low, &result->high);
+    free(estimates);
+}
+
+int vpxt_bench_run(const VPXT_BENCH_CONFIG *config, vpxt_bench_fn_t fn,
+                   void *arg, VPXT_BENCH_RESULT *result)
+{
+    VPXT_AFFINITY affinity;
+    int run;
+    int state = 0;
+
+    vpxt_bench_clear(result);
+
+    if (config->cpu >= 0)
+    {
+        vpxt_thread_affinity_save(&affinity);
+        vpxt_thread_pin(config->cpu, config->cpu_count);
+    }
+
+    for (run = -config->warmup; run < config->repetitions; run++)
+    {
+        double sample = 0;
+
+        state = fn(arg, run, &sample);
+
+        if (state)
+            break;
+
+        if (run >= 0)
+            vpxt_bench_add(result, sample);
+    }
+
+    if (config->cpu >= 0)
+        vpxt_thread_affinity_restore(&affinity);
+
+    vpxt_bench_finish(config, result);
+
+    return state;
+}
+
+int vpxt_bench_compare(const VPXT_BENCH_CONFIG *config,
+                       const VPXT_BENCH_RESULT *base,
+                       const VPXT_BENCH_RESULT *test,
+                       double *low, double *high)
+{
+    double base_scratch[VPXT_BENCH_MAX_SAMPLES];
+    double test_scratch[VPXT_BENCH_MAX_SAMPLES];
+    int resamples = bench_resamples(config);
+    double *estimates;
+    unsigned int state = 0x2545f491;
+    int i;
+
+    *low = 0;
+    *high = 0;
+
+    if (!base->count || !test->count)
+        return 0;
+
+    estimates = (double *)malloc(resamples * sizeof(double));
+
+    // a single sample on both sides resamples to the plain difference
+    if (!estimates || (base->count < 2 && test->count < 2))
+        resamples = 1;
+
+    for (i = 0; i < resamples; i++)
+    {
+        double base_median = base->median;
+        double test_median = test->median;
+        double estimate;
+
+        if (estimates)
+        {
+            base_median = bench_resample_median(base->samples, base->count,
+                base_scratch, &state);
+            test_median = bench_resample_median(test->samples, test->count,
+                test_scratch, &state);
+        }
+
+        if (base_median > 0)
+            estimate = test_median / base_median - 1;
+        else
+            estimate = test_median > base_median ? 1 :
+                test_median < base_median ? -1 : 0;
+
+        if (!estimates)
+        {
+            *low = *high = estimate;
+            return estimate < 0 ? -1 : estimate > 0;
+        }
+
+        estimates[i] = estimate;
+    }
+
+    qsort(estimates, resamples, sizeof(double), bench_compare_double);
+    bench_interval(config, estimates, resamples, low, high);
+    free(estimates);
+
+    if (*high < 0)
+        return -1;
+
+    if (*low > 0)
+        return 1;
+
+    return 0;
+}
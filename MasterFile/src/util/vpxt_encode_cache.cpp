@@ -0,0 +1,378 @@
+#include "vpxt_encode_cache.h"
+#include "vpxt_thread.h"
+#include "md5_utils.h"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <direct.h>
+#include <process.h>
+#include <sys/utime.h>
+#define getpid _getpid
+#define utime _utime
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+// Written last, an entry without it is incomplete.
+#define CACHE_META "meta"
+
+struct cache_entry
+{
+    std::string key;
+    long long bytes;
+    time_t last_used;
+};
+
+const char *vpxt_encode_cache_dir()
+{
+    const char *env = getenv("VPXT_ENCODE_CACHE");
+
+    return env && *env ? env : NULL;
+}
+
+static long long cache_quota()
+{
+    const char *env = getenv("VPXT_ENCODE_CACHE_MB");
+    long long mb = env && *env ? atoll(env) : VPXT_ENCODE_CACHE_MB;
+
+    return (mb > 0 ? mb : 0) * 1024 * 1024;
+}
+
+static std::string cache_path(const char *key, const char *name)
+{
+    std::string path = vpxt_encode_cache_dir();
+#if defined(_WIN32)
+    path += "\\";
+#else
+    path += "/";
+#endif
+    path += key;
+    path += ".";
+    path += name;
+
+    return path;
+}
+
+static int cache_copy(const char *input, const char *output)
+{
+    std::ifstream input_file(input, std::ios::binary);
+
+    if (!input_file.is_open())
+        return -1;
+
+    std::ofstream output_file(output, std::ios::binary);
+    output_file << input_file.rdbuf();
+    output_file.close();
+
+    return output_file.fail() ? -1 : 0;
+}
+
+// Moves a finished temporary file in place of the entry file.
+static int cache_commit(const std::string &temp, const std::string &path)
+{
+#if defined(_WIN32)
+    remove(path.c_str());
+#endif
+    if (rename(temp.c_str(), path.c_str()) == 0)
+        return 0;
+
+    remove(temp.c_str());
+    return -1;
+}
+
+// Digest of a source as of its size and mtime, so the encodes of a run hash
+// each source once.
+struct source_digest
+{
+    long long size;
+    time_t mtime;
+    unsigned char digest[16];
+};
+
+struct source_digest_memo
+{
+    vpxt_mutex_t lock;
+    std::map<std::string, source_digest> digests;
+
+    source_digest_memo()
+    {
+        vpxt_mutex_init(&lock);
+    }
+};
+
+static source_digest_memo source_digests;
+
+static int source_md5(const char *source, unsigned char digest[16])
+{
+    struct stat stat_buf;
+    unsigned char buf[65536];
+    source_digest entry;
+    MD5Context md5;
+    size_t bytes;
+    FILE *in;
+
+    if (stat(source, &stat_buf))
+        return -1;
+
+    vpxt_mutex_lock(&source_digests.lock);
+    std::map<std::string, source_digest>::iterator it =
+        source_digests.digests.find(source);
+    int found = it != source_digests.digests.end() &&
+        it->second.size == (long long)stat_buf.st_size &&
+        it->second.mtime == stat_buf.st_mtime;
+
+    if (found)
+        memcpy(digest, it->second.digest, 16);
+
+    vpxt_mutex_unlock(&source_digests.lock);
+
+    if (found)
+        return 0;
+
+    in = fopen(source, "rb");
+
+    if (!in)
+        return -1;
+
+    MD5Init(&md5);
+
+    while ((bytes = fread(buf, 1, sizeof(buf), in)) > 0)
+        MD5Update(&md5, buf, (unsigned)bytes);
+
+    fclose(in);
+    MD5Final(digest, &md5);
+
+    entry.size = stat_buf.st_size;
+    entry.mtime = stat_buf.st_mtime;
+    memcpy(entry.digest, digest, 16);
+
+    vpxt_mutex_lock(&source_digests.lock);
+    source_digests.digests[source] = entry;
+    vpxt_mutex_unlock(&source_digests.lock);
+
+    return 0;
+}
+
+int vpxt_encode_cache_key(const char *source, const std::string &config,
+                          char key[33])
+{
+    unsigned char digest[16];
+    MD5Context md5;
+    int i;
+
+    if (source_md5(source, digest))
+        return -1;
+
+    // the source's digest keeps equal configs of different sources apart
+    MD5Init(&md5);
+    MD5Update(&md5, digest, sizeof(digest));
+    MD5Update(&md5, (const md5byte *)config.data(), (unsigned)config.size());
+    MD5Final(digest, &md5);
+
+    for (i = 0; i < 16; i++)
+        sprintf(key + 2 * i, "%02x", digest[i]);
+
+    return 0;
+}
+
+int vpxt_encode_cache_fetch(const char *key, int count,
+                            const char *const *names,
+                            const char *const *paths, std::string *metrics)
+{
+    std::string meta = cache_path(key, CACHE_META);
+    struct stat stat_buf;
+    int i;
+
+    if (!vpxt_encode_cache_dir() || stat(meta.c_str(), &stat_buf))
+        return -1;
+
+    for (i = 0; i < count; i++)
+        if (paths[i] &&
+            stat(cache_path(key, names[i]).c_str(), &stat_buf))
+            return -1;
+
+    for (i = 0; i < count; i++)
+        if (paths[i] &&
+            cache_copy(cache_path(key, names[i]).c_str(), paths[i]))
+            return -1;
+
+    if (metrics)
+    {
+        std::ifstream meta_file(meta.c_str(), std::ios::binary);
+        std::ostringstream text;
+
+        text << meta_file.rdbuf();
+        *metrics = text.str();
+    }
+
+    // last use orders entries for eviction
+    utime(meta.c_str(), NULL);
+
+    return 0;
+}
+
+static void cache_list(std::vector<std::string> &files)
+{
+    std::string dir = vpxt_encode_cache_dir();
+#if defined(_WIN32)
+    WIN32_FIND_DATA data;
+    HANDLE find = FindFirstFile((dir + "\\*").c_str(), &data);
+
+    if (find == INVALID_HANDLE_VALUE)
+        return;
+
+    do
+        files.push_back(data.cFileName);
+    while (FindNextFile(find, &data));
+
+    FindClose(find);
+#else
+    DIR *dir_handle = opendir(dir.c_str());
+    struct dirent *entry;
+
+    if (!dir_handle)
+        return;
+
+    while ((entry = readdir(dir_handle)) != NULL)
+        files.push_back(entry->d_name);
+
+    closedir(dir_handle);
+#endif
+}
+
+static bool cache_older(const cache_entry &a, const cache_entry &b)
+{
+    return a.last_used < b.last_used;
+}
+
+// Removes least recently used entries, other than keep, until the cache
+// fits its quota.
+static void cache_evict(const char *keep)
+{
+    long long quota = cache_quota();
+    long long total = 0;
+    std::vector<std::string> files;
+    std::vector<cache_entry> entries;
+    size_t i;
+    size_t j;
+
+    cache_list(files);
+
+    for (i = 0; i < files.size(); i++)
+    {
+        size_t dot = files[i].find('.');
+        struct stat stat_buf;
+
+        if (dot == std::string::npos || files[i][0] == '.' ||
+            stat(cache_path(files[i].substr(0, dot).c_str(),
+            files[i].c_str() + dot + 1).c_str(), &stat_buf))
+            continue;
+
+        std::string key = files[i].substr(0, dot);
+
+        for (j = 0; j < entries.size(); j++)
+            if (entries[j].key == key)
+                break;
+
+        if (j == entries.size())
+        {
+            cache_entry entry;
+            entry.key = key;
+            entry.bytes = 0;
+            entry.last_used = 0;
+            entries.push_back(entry);
+        }
+
+        entries[j].bytes += stat_buf.st_size;
+        total += stat_buf.st_size;
+
+        if (files[i].compare(dot + 1, std::string::npos, CACHE_META) == 0)
+            entries[j].last_used = stat_buf.st_mtime;
+    }
+
+    if (total <= quota)
+        return;
+
+    std::sort(entries.begin(), entries.end(), cache_older);
+
+    for (i = 0; i < entries.size() && total > quota; i++)
+    {
+        if (entries[i].key == keep)
+            continue;
+
+        // entries being written have no meta yet
+        if (entries[i].last_used == 0)
+            continue;
+
+        remove(cache_path(entries[i].key.c_str(), CACHE_META).c_str());
+
+        for (j = 0; j < files.size(); j++)
+            if (files[j].compare(0, entries[i].key.size() + 1,
+                entries[i].key + ".") == 0)
+                remove(cache_path(entries[i].key.c_str(),
+                    files[j].c_str() + entries[i].key.size() + 1).c_str());
+
+        total -= entries[i].bytes;
+    }
+}
+
+int vpxt_encode_cache_store(const char *key, int count,
+                            const char *const *names,
+                            const char *const *paths,
+                            const std::string &metrics)
+{
+    char suffix[64];
+    int i;
+
+    if (!vpxt_encode_cache_dir())
+        return -1;
+
+#if defined(_WIN32)
+    _mkdir(vpxt_encode_cache_dir());
+#else
+    mkdir(vpxt_encode_cache_dir(), 0755);
+#endif
+
+    // threads of one process storing the same entry have their own stacks
+    snprintf(suffix, sizeof(suffix), ".tmp%d_%p", (int)getpid(),
+        (void *)suffix);
+
+    for (i = 0; i < count; i++)
+    {
+        std::string path = cache_path(key, names[i]);
+
+        if (!paths[i] || cache_copy(paths[i], (path + suffix).c_str()))
+        {
+            remove((path + suffix).c_str());
+            continue;
+        }
+
+        if (cache_commit(path + suffix, path))
+            return -1;
+    }
+
+    std::string meta = cache_path(key, CACHE_META);
+    std::ofstream meta_file((meta + suffix).c_str(), std::ios::binary);
+
+    meta_file << metrics;
+    meta_file.close();
+
+    if (meta_file.fail() || cache_commit(meta + suffix, meta))
+        return -1;
+
+    cache_evict(key);
+
+    return 0;
+}
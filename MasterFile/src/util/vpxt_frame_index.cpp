@@ -0,0 +1,202 @@
+#include "vpxt_frame_index.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#define INDEX_MAGIC "VPXTIDX1"
+#define INDEX_MAGIC_SZ 8
+// magic, file size, mtime, mtime nanoseconds, seven header fields and the
+// frame count
+#define INDEX_HEADER_SZ (INDEX_MAGIC_SZ + 8 + 8 + 4 + 7 * 4 + 4)
+#define INDEX_ENTRY_SZ (8 + 8 + 4 + 4 + 1 + 1 + 2 + 2)
+
+// What an index was built from, a changed file has a new size or mtime.
+struct index_stamp
+{
+    uint64_t size;
+    uint64_t mtime;
+    uint32_t mtime_nsec;
+};
+
+static int index_file_stamp(const char *file, index_stamp *stamp)
+{
+    struct stat stat_buf;
+
+    if (stat(file, &stat_buf))
+        return -1;
+
+    stamp->size = stat_buf.st_size;
+    stamp->mtime = stat_buf.st_mtime;
+#if defined(_WIN32)
+    stamp->mtime_nsec = 0;
+#elif defined(__APPLE__)
+    stamp->mtime_nsec = stat_buf.st_mtimespec.tv_nsec;
+#else
+    stamp->mtime_nsec = stat_buf.st_mtim.tv_nsec;
+#endif
+
+    return 0;
+}
+
+static std::string index_path(const char *file)
+{
+    std::string path = file;
+
+    path += ".idx";
+
+    return path;
+}
+
+static void put_le(std::string &out, uint64_t value, int bytes)
+{
+    int i;
+
+    for (i = 0; i < bytes; i++)
+        out += (char)(value >> (8 * i));
+}
+
+static uint64_t get_le(const unsigned char *in, int bytes)
+{
+    uint64_t value = 0;
+    int i;
+
+    for (i = bytes - 1; i >= 0; i--)
+        value = value << 8 | in[i];
+
+    return value;
+}
+
+int vpxt_frame_index_load(const char *file, VPXT_FRAME_INDEX *index)
+{
+    std::ifstream in(index_path(file).c_str(), std::ios::binary);
+    std::ostringstream text;
+    index_stamp stamp;
+    size_t count;
+    size_t i;
+
+    if (!in.is_open() || index_file_stamp(file, &stamp))
+        return -1;
+
+    text << in.rdbuf();
+
+    std::string data = text.str();
+    const unsigned char *p = (const unsigned char *)data.data();
+
+    if (data.size() < INDEX_HEADER_SZ ||
+        memcmp(p, INDEX_MAGIC, INDEX_MAGIC_SZ) ||
+        get_le(p + 8, 8) != stamp.size || get_le(p + 16, 8) != stamp.mtime ||
+        get_le(p + 24, 4) != stamp.mtime_nsec)
+        return -1;
+
+    p += 28;
+    index->kind = (int)get_le(p, 4);
+    index->fourcc = (unsigned int)get_le(p + 4, 4);
+    index->width = (unsigned int)get_le(p + 8, 4);
+    index->height = (unsigned int)get_le(p + 12, 4);
+    index->fps_num = (unsigned int)get_le(p + 16, 4);
+    index->fps_den = (unsigned int)get_le(p + 20, 4);
+    index->header_length = (unsigned int)get_le(p + 24, 4);
+    count = (size_t)get_le(p + 28, 4);
+    p += 32;
+
+    if ((data.size() - INDEX_HEADER_SZ) / INDEX_ENTRY_SZ != count ||
+        (data.size() - INDEX_HEADER_SZ) % INDEX_ENTRY_SZ)
+        return -1;
+
+    index->frames.resize(count);
+
+    for (i = 0; i < count; i++, p += INDEX_ENTRY_SZ)
+    {
+        VPXT_FRAME_INDEX_ENTRY *frame = &index->frames[i];
+
+        frame->offset = get_le(p, 8);
+        frame->pts = get_le(p + 8, 8);
+        frame->size = (uint32_t)get_le(p + 16, 4);
+        frame->first_part_size = (uint32_t)get_le(p + 20, 4);
+        frame->flags = p[24];
+        frame->version = p[25];
+        frame->width = (uint16_t)get_le(p + 26, 2);
+        frame->height = (uint16_t)get_le(p + 28, 2);
+    }
+
+    return 0;
+}
+
+int vpxt_frame_index_save(const char *file, const VPXT_FRAME_INDEX *index)
+{
+    std::string path = index_path(file);
+    std::string data;
+    index_stamp stamp;
+    char suffix[64];
+    size_t i;
+
+    if (index_file_stamp(file, &stamp))
+        return -1;
+
+    data.reserve(INDEX_HEADER_SZ + index->frames.size() * INDEX_ENTRY_SZ);
+    data.append(INDEX_MAGIC, INDEX_MAGIC_SZ);
+    put_le(data, stamp.size, 8);
+    put_le(data, stamp.mtime, 8);
+    put_le(data, stamp.mtime_nsec, 4);
+    put_le(data, index->kind, 4);
+    put_le(data, index->fourcc, 4);
+    put_le(data, index->width, 4);
+    put_le(data, index->height, 4);
+    put_le(data, index->fps_num, 4);
+    put_le(data, index->fps_den, 4);
+    put_le(data, index->header_length, 4);
+    put_le(data, index->frames.size(), 4);
+
+    for (i = 0; i < index->frames.size(); i++)
+    {
+        const VPXT_FRAME_INDEX_ENTRY *frame = &index->frames[i];
+
+        put_le(data, frame->offset, 8);
+        put_le(data, frame->pts, 8);
+        put_le(data, frame->size, 4);
+        put_le(data, frame->first_part_size, 4);
+        put_le(data, frame->flags, 1);
+        put_le(data, frame->version, 1);
+        put_le(data, frame->width, 2);
+        put_le(data, frame->height, 2);
+    }
+
+    // jobs running side by side may index the same file, each writes its
+    // own temporary file and the last rename wins
+    snprintf(suffix, sizeof(suffix), ".tmp%d_%p", (int)getpid(),
+        (void *)suffix);
+
+    std::string temp = path + suffix;
+    std::ofstream out(temp.c_str(), std::ios::binary);
+
+    out.write(data.data(), data.size());
+    out.close();
+
+    if (out.fail())
+    {
+        remove(temp.c_str());
+        return -1;
+    }
+
+#if defined(_WIN32)
+    remove(path.c_str());
+#endif
+    if (rename(temp.c_str(), path.c_str()))
+    {
+        remove(temp.c_str());
+        return -1;
+    }
+
+    return 0;
+}
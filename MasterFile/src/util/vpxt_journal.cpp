@@ -0,0 +1,251 @@
+#include "vpxt_journal.h"
+#include "vpxt_json.h"
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Journal the running test records its artifacts to.  Set before any
+// thread of the test starts and only read afterwards.
+static std::string current_path;
+static int current_test = -1;
+static const VPXT_JOURNAL *resume_journal = NULL;
+
+static void json_field(std::string &out, const char *name,
+                       const std::string &value)
+{
+    out += ",\"";
+    out += name;
+    out += "\":";
+    vpxt_json_string(out, value);
+}
+
+static void json_field(std::string &out, const char *name, int value)
+{
+    char number[32];
+
+    snprintf(number, sizeof(number), ",\"%s\":%d", name, value);
+    out += number;
+}
+
+// Appends one record and flushes it to disk.
+static int journal_append(const char *path, std::string record)
+{
+    int fail;
+
+    record += "}\n";
+#if defined(_WIN32)
+    int fd = _open(path, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY,
+        _S_IREAD | _S_IWRITE);
+
+    if (fd < 0)
+        return -1;
+
+    fail = _write(fd, record.data(), (unsigned)record.size()) !=
+        (int)record.size();
+    fail |= _commit(fd) != 0;
+    _close(fd);
+#else
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+
+    if (fd < 0)
+        return -1;
+
+    fail = write(fd, record.data(), record.size()) != (ssize_t)record.size();
+    fail |= fsync(fd) != 0;
+    close(fd);
+#endif
+
+    return fail ? -1 : 0;
+}
+
+static std::string journal_record(const char *event)
+{
+    std::string record = "{\"event\":";
+
+    vpxt_json_string(record, event);
+
+    return record;
+}
+
+int vpxt_journal_write_run(const char *path, int mode)
+{
+    std::string record = journal_record("run");
+
+    json_field(record, "mode", mode);
+
+    return journal_append(path, record);
+}
+
+int vpxt_journal_write_start(const char *path, int test,
+                             const std::string &name,
+                             const std::string &folder)
+{
+    std::string record = journal_record("start");
+
+    json_field(record, "test", test);
+    json_field(record, "name", name);
+    json_field(record, "folder", folder);
+
+    return journal_append(path, record);
+}
+
+int vpxt_journal_write_end(const char *path, int test, int result)
+{
+    std::string record = journal_record("end");
+
+    json_field(record, "test", test);
+    json_field(record, "result", result);
+
+    return journal_append(path, record);
+}
+
+int vpxt_journal_write_done(const char *path)
+{
+    return journal_append(path, journal_record("done"));
+}
+
+void vpxt_journal_set_current(const char *path, int test)
+{
+    current_path = path ? path : "";
+    current_test = test;
+}
+
+int vpxt_journal_recording()
+{
+    return !current_path.empty();
+}
+
+void vpxt_journal_add_artifact(const char *key, const char *output,
+                               const std::string &metrics)
+{
+    if (current_path.empty())
+        return;
+
+    std::string record = journal_record("artifact");
+
+    json_field(record, "test", current_test);
+    json_field(record, "key", key);
+    json_field(record, "output", output);
+    json_field(record, "metrics", metrics);
+
+    journal_append(current_path.c_str(), record);
+}
+
+void vpxt_journal_set_resume(const VPXT_JOURNAL *journal)
+{
+    resume_journal = journal;
+}
+
+const VPXT_JOURNAL_ARTIFACT *vpxt_journal_find_artifact(const char *key)
+{
+    if (!resume_journal)
+        return NULL;
+
+    for (size_t i = resume_journal->artifacts.size(); i > 0; i--)
+        if (resume_journal->artifacts[i - 1].key == key)
+            return &resume_journal->artifacts[i - 1];
+
+    return NULL;
+}
+
+static VPXT_JOURNAL_TEST *journal_test(VPXT_JOURNAL *journal, int test)
+{
+    if (test < 0)
+        return NULL;
+
+    if ((size_t)test >= journal->tests.size())
+    {
+        VPXT_JOURNAL_TEST empty;
+        empty.result = -1;
+        journal->tests.resize(test + 1, empty);
+    }
+
+    return &journal->tests[test];
+}
+
+int vpxt_journal_load(const char *path, VPXT_JOURNAL *journal)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::string line;
+
+    journal->mode = -1;
+    journal->done = 0;
+    journal->tests.clear();
+    journal->artifacts.clear();
+
+    if (!in.is_open())
+        return -1;
+
+    while (std::getline(in, line))
+    {
+        std::vector<std::string> names;
+        std::vector<std::string> values;
+
+        if (vpxt_json_parse_record(line, names, values))
+            continue;
+
+        const std::string *event = vpxt_json_field(names, values, "event");
+        const std::string *test = vpxt_json_field(names, values, "test");
+        VPXT_JOURNAL_TEST *record = test ?
+            journal_test(journal, atoi(test->c_str())) : NULL;
+
+        if (!event)
+            continue;
+
+        if (*event == "run")
+        {
+            const std::string *mode = vpxt_json_field(names, values, "mode");
+
+            journal->mode = mode ? atoi(mode->c_str()) : -1;
+        }
+        else if (*event == "done")
+            journal->done = 1;
+        else if (*event == "start" && record)
+        {
+            const std::string *name = vpxt_json_field(names, values, "name");
+            const std::string *folder =
+                vpxt_json_field(names, values, "folder");
+
+            record->name = name ? *name : "";
+            record->folder = folder ? *folder : "";
+            record->result = -1;
+        }
+        else if (*event == "end" && record)
+        {
+            const std::string *result =
+                vpxt_json_field(names, values, "result");
+
+            record->result = result ? atoi(result->c_str()) : -1;
+        }
+        else if (*event == "artifact" && record)
+        {
+            const std::string *key = vpxt_json_field(names, values, "key");
+            const std::string *output =
+                vpxt_json_field(names, values, "output");
+            const std::string *metrics =
+                vpxt_json_field(names, values, "metrics");
+            VPXT_JOURNAL_ARTIFACT artifact;
+
+            if (!key || !output)
+                continue;
+
+            artifact.test = atoi(test->c_str());
+            artifact.key = *key;
+            artifact.output = *output;
+            artifact.metrics = metrics ? *metrics : "";
+            journal->artifacts.push_back(artifact);
+        }
+    }
+
+    return 0;
+}
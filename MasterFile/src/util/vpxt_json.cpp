@@ -0,0 +1,160 @@
+#include "vpxt_json.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void vpxt_json_string(std::string &out, const std::string &value)
+{
+    out += '"';
+
+    for (size_t i = 0; i < value.size(); i++)
+    {
+        unsigned char c = value[i];
+
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (c == '\n')
+            out += "\\n";
+        else if (c == '\r')
+            out += "\\r";
+        else if (c == '\t')
+            out += "\\t";
+        else if (c < 0x20)
+        {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            out += escape;
+        }
+        else
+            out += c;
+    }
+
+    out += '"';
+}
+
+int vpxt_json_parse_string(const std::string &line, size_t *pos,
+                           std::string &value)
+{
+    size_t i = *pos;
+
+    if (i >= line.size() || line[i] != '"')
+        return -1;
+
+    value.clear();
+
+    for (i++; i < line.size() && line[i] != '"'; i++)
+    {
+        if (line[i] != '\\')
+        {
+            value += line[i];
+            continue;
+        }
+
+        if (++i >= line.size())
+            return -1;
+
+        if (line[i] == 'n')
+            value += '\n';
+        else if (line[i] == 'r')
+            value += '\r';
+        else if (line[i] == 't')
+            value += '\t';
+        else if (line[i] == 'u')
+        {
+            if (i + 4 >= line.size())
+                return -1;
+
+            value += (char)strtol(line.substr(i + 1, 4).c_str(), NULL, 16);
+            i += 4;
+        }
+        else
+            value += line[i];
+    }
+
+    if (i >= line.size())
+        return -1;
+
+    *pos = i + 1;
+    return 0;
+}
+
+static void json_skip_space(const std::string &line, size_t *pos)
+{
+    while (*pos < line.size() && (line[*pos] == ' ' || line[*pos] == '\t'))
+        (*pos)++;
+}
+
+int vpxt_json_parse_record(const std::string &line,
+                           std::vector<std::string> &names,
+                           std::vector<std::string> &values)
+{
+    size_t pos = 0;
+
+    json_skip_space(line, &pos);
+
+    if (pos >= line.size() || line[pos++] != '{')
+        return -1;
+
+    while (pos < line.size())
+    {
+        std::string name;
+        std::string value;
+
+        json_skip_space(line, &pos);
+
+        if (vpxt_json_parse_string(line, &pos, name))
+            return -1;
+
+        json_skip_space(line, &pos);
+
+        if (pos >= line.size() || line[pos++] != ':')
+            return -1;
+
+        json_skip_space(line, &pos);
+
+        if (pos < line.size() && line[pos] == '"')
+        {
+            if (vpxt_json_parse_string(line, &pos, value))
+                return -1;
+        }
+        else
+        {
+            size_t end = line.find_first_of(",} \t", pos);
+
+            if (end == std::string::npos)
+                return -1;
+
+            value = line.substr(pos, end - pos);
+            pos = end;
+        }
+
+        names.push_back(name);
+        values.push_back(value);
+
+        json_skip_space(line, &pos);
+
+        if (pos >= line.size())
+            return -1;
+
+        if (line[pos] == '}')
+            return 0;
+
+        if (line[pos++] != ',')
+            return -1;
+    }
+
+    return -1;
+}
+
+const std::string *vpxt_json_field(const std::vector<std::string> &names,
+                                   const std::vector<std::string> &values,
+                                   const char *name)
+{
+    for (size_t i = 0; i < names.size(); i++)
+        if (names[i] == name)
+            return &values[i];
+
+    return NULL;
+}
@@ -0,0 +1,318 @@
+#include "vpxt_scheduler.h"
+#include "vpxt_thread.h"
+#include "vpxt_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#endif
+
+// How often running tasks are checked against their limits.
+#define SCHED_POLL_US 20000
+
+static uint64_t sched_env(const char *name)
+{
+    const char *env = getenv(name);
+
+    return env && *env && atof(env) > 0 ? (uint64_t)atof(env) : 0;
+}
+
+int vpxt_sched_init(VPXT_SCHEDULER *sched, int workers)
+{
+    const char *env = getenv("VPXT_TEST_WORKERS");
+
+    memset(sched, 0, sizeof(*sched));
+
+    if (workers < 1 && env && *env)
+        workers = atoi(env);
+
+    if (workers < 1)
+        workers = vpxt_cpu_count();
+
+#if defined(_WIN32)
+    workers = 1;
+#endif
+
+    sched->tasks = (VPXT_TASK *)calloc(workers, sizeof(VPXT_TASK));
+
+    if (!sched->tasks)
+        return -1;
+
+    sched->workers = workers;
+    sched->timeout_us = sched_env("VPXT_TEST_TIMEOUT") * 1000000;
+    sched->rss_limit = sched_env("VPXT_TEST_RSS_LIMIT") * 1024 * 1024;
+
+    return 0;
+}
+
+void vpxt_sched_destroy(VPXT_SCHEDULER *sched)
+{
+    free(sched->tasks);
+    memset(sched, 0, sizeof(*sched));
+}
+
+int vpxt_sched_running(const VPXT_SCHEDULER *sched)
+{
+    return sched->running;
+}
+
+int vpxt_sched_can_start(const VPXT_SCHEDULER *sched, int exclusive)
+{
+    if (sched->exclusive || sched->running >= sched->workers)
+        return 0;
+
+    return !exclusive || sched->running == 0;
+}
+
+#if !defined(_WIN32)
+// Runs in the child, never returns.
+static void sched_child(const VPXT_SCHEDULER *sched, const char *output,
+                        int result_pipe, vpxt_task_fn_t fn, void *arg)
+{
+    int result;
+
+    // own process group so processes the task starts are killed with it
+    setpgid(0, 0);
+
+    if (output)
+    {
+        int fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+    }
+
+#if !defined(__linux__)
+    // resident size can only be read on linux, limit the address space
+    // instead
+    if (sched->rss_limit)
+    {
+        struct rlimit limit;
+
+        limit.rlim_cur = sched->rss_limit;
+        limit.rlim_max = sched->rss_limit;
+        setrlimit(RLIMIT_AS, &limit);
+    }
+#endif
+
+    result = fn(arg);
+    fflush(NULL);
+
+    if (result_pipe >= 0 &&
+        write(result_pipe, &result, sizeof(result)) != sizeof(result))
+        _exit(1);
+
+    _exit(0);
+}
+
+static uint64_t sched_rss(pid_t pid)
+{
+    uint64_t rss = 0;
+#if defined(__linux__)
+    char path[64];
+    unsigned long size;
+    unsigned long resident;
+    FILE *statm;
+
+    snprintf(path, sizeof(path), "/proc/%d/statm", (int)pid);
+    statm = fopen(path, "r");
+
+    if (!statm)
+        return 0;
+
+    if (fscanf(statm, "%lu %lu", &size, &resident) == 2)
+        rss = (uint64_t)resident * sysconf(_SC_PAGESIZE);
+
+    fclose(statm);
+#endif
+    return rss;
+}
+
+static void sched_check_limits(VPXT_SCHEDULER *sched)
+{
+    uint64_t now = vpxt_wall_time_us();
+    int i;
+
+    for (i = 0; i < sched->running; i++)
+    {
+        VPXT_TASK *task = &sched->tasks[i];
+
+        if (task->pid <= 0 || task->killed)
+            continue;
+
+        if (sched->timeout_us && now - task->start_time > sched->timeout_us)
+            task->killed = VPXT_TASK_TIMED_OUT;
+        else if (sched->rss_limit && sched_rss(task->pid) > sched->rss_limit)
+            task->killed = VPXT_TASK_OUT_OF_MEMORY;
+        else
+            continue;
+
+        kill(-task->pid, SIGKILL);
+        kill(task->pid, SIGKILL);
+    }
+}
+
+// Result of a reaped child: whatever it sent back, otherwise why it ended.
+static int sched_child_result(VPXT_TASK *task, int status)
+{
+    int result;
+
+    if (task->result_pipe >= 0)
+    {
+        ssize_t bytes = read(task->result_pipe, &result, sizeof(result));
+
+        close(task->result_pipe);
+        task->result_pipe = -1;
+
+        if (bytes == sizeof(result))
+            return result;
+    }
+
+    if (task->killed)
+        return task->killed;
+
+    return WIFEXITED(status) ? VPXT_TASK_EXITED : VPXT_TASK_CRASHED;
+}
+#endif
+
+int vpxt_sched_start(VPXT_SCHEDULER *sched, int job, int exclusive,
+                     const char *output, vpxt_task_fn_t fn, void *arg)
+{
+    VPXT_TASK *task;
+
+    if (!vpxt_sched_can_start(sched, exclusive))
+        return -1;
+
+    task = &sched->tasks[sched->running];
+    memset(task, 0, sizeof(*task));
+    task->job = job;
+    task->exclusive = exclusive;
+    task->result = VPXT_TASK_CRASHED;
+    task->result_pipe = -1;
+    task->start_time = vpxt_wall_time_us();
+
+#if !defined(_WIN32)
+    int fds[2];
+
+    if (pipe(fds))
+        fds[0] = fds[1] = -1;
+
+    // buffered output would otherwise be written again by the child
+    fflush(NULL);
+    task->pid = fork();
+
+    if (task->pid == 0)
+    {
+        if (fds[0] >= 0)
+            close(fds[0]);
+
+        sched_child(sched, output, fds[1], fn, arg);
+    }
+
+    if (fds[1] >= 0)
+        close(fds[1]);
+
+    if (task->pid > 0)
+    {
+        setpgid(task->pid, task->pid);
+        task->result_pipe = fds[0];
+    }
+    else if (fds[0] >= 0)
+        close(fds[0]);
+#endif
+
+    // no child, the task has already finished once it is started
+    if (task->pid <= 0)
+    {
+        task->pid = 0;
+        task->result = fn(arg);
+    }
+
+    sched->running++;
+    sched->exclusive = exclusive;
+
+    return 0;
+}
+
+int vpxt_sched_wait(VPXT_SCHEDULER *sched, int *job, int *result)
+{
+    int i;
+
+    if (!sched->running)
+        return -1;
+
+    for (;;)
+    {
+        for (i = 0; i < sched->running; i++)
+            if (sched->tasks[i].pid == 0)
+                break;
+
+        if (i < sched->running)
+            break;
+
+#if !defined(_WIN32)
+        int limits = sched->timeout_us || sched->rss_limit;
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, limits ? WNOHANG : 0);
+
+        if (pid < 0 && errno != EINTR)
+            return -1;
+
+        if (pid == 0)
+        {
+            sched_check_limits(sched);
+            usleep(SCHED_POLL_US);
+            continue;
+        }
+
+        for (i = 0; i < sched->running; i++)
+        {
+            VPXT_TASK *task = &sched->tasks[i];
+
+            if (pid > 0 && task->pid == pid)
+            {
+                task->result = sched_child_result(task, status);
+                task->pid = 0;
+            }
+        }
+#endif
+    }
+
+    *job = sched->tasks[i].job;
+    *result = sched->tasks[i].result;
+
+    if (sched->tasks[i].exclusive)
+        sched->exclusive = 0;
+
+    sched->tasks[i] = sched->tasks[--sched->running];
+
+    return 0;
+}
+
+const char *vpxt_sched_result_name(int result)
+{
+    if (result == VPXT_TASK_CRASHED)
+        return "Crashed";
+
+    if (result == VPXT_TASK_EXITED)
+        return "Exited without a result";
+
+    if (result == VPXT_TASK_TIMED_OUT)
+        return "Timed out";
+
+    if (result == VPXT_TASK_OUT_OF_MEMORY)
+        return "Over memory limit";
+
+    return NULL;
+}
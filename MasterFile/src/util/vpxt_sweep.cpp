@@ -0,0 +1,162 @@
+#include "vpxt_sweep.h"
+#include "vpxt_utilities.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Sweep the calling thread is running a job of and how deep it is in timed
+// sections.
+static VPXT_THREAD_LOCAL VPXT_SWEEP *current_sweep = NULL;
+static VPXT_THREAD_LOCAL int timed_depth = 0;
+
+int vpxt_sweep_init(VPXT_SWEEP *sweep, int threads)
+{
+    const char *env = getenv("VPXT_SWEEP_THREADS");
+
+    memset(sweep, 0, sizeof(*sweep));
+
+    if (threads < 1 && env && *env)
+        threads = atoi(env);
+
+    if (threads < 1)
+        threads = vpxt_cpu_count();
+
+    vpxt_mutex_init(&sweep->lock);
+    vpxt_cond_init(&sweep->changed);
+
+    // the thread calling vpxt_sweep_run works on jobs as well
+    return vpxt_pool_create(&sweep->pool, threads - 1);
+}
+
+void vpxt_sweep_destroy(VPXT_SWEEP *sweep)
+{
+    vpxt_pool_destroy(&sweep->pool);
+    vpxt_cond_destroy(&sweep->changed);
+    vpxt_mutex_destroy(&sweep->lock);
+}
+
+// Jobs only start while no timed section is open or waiting.
+static void sweep_enter(VPXT_SWEEP *sweep)
+{
+    vpxt_mutex_lock(&sweep->lock);
+
+    while (sweep->timing || sweep->timing_waiting)
+        vpxt_cond_wait(&sweep->changed, &sweep->lock);
+
+    sweep->running++;
+    vpxt_mutex_unlock(&sweep->lock);
+}
+
+static void sweep_leave(VPXT_SWEEP *sweep)
+{
+    vpxt_mutex_lock(&sweep->lock);
+    sweep->running--;
+    vpxt_cond_broadcast(&sweep->changed);
+    vpxt_mutex_unlock(&sweep->lock);
+}
+
+static void sweep_job(void *arg, int job)
+{
+    VPXT_SWEEP *sweep = (VPXT_SWEEP *)arg;
+    VPXT_PRINT_CAPTURE *captures = (VPXT_PRINT_CAPTURE *)sweep->captures;
+    int result;
+
+    sweep_enter(sweep);
+    current_sweep = sweep;
+
+    if (captures)
+        vpxt_print_capture_set(&captures[job]);
+
+    result = sweep->fn(sweep->arg, job);
+
+    vpxt_print_capture_set(NULL);
+    current_sweep = NULL;
+    sweep_leave(sweep);
+
+    vpxt_mutex_lock(&sweep->lock);
+
+    if (sweep->results)
+        sweep->results[job] = result;
+
+    sweep->done[job] = 1;
+
+    // print every finished job that all earlier ones have been printed for
+    while (captures && sweep->done[sweep->next_print])
+    {
+        vpxt_print_capture_flush(&captures[sweep->next_print]);
+        sweep->next_print++;
+
+        if (sweep->next_print == sweep->job_count)
+            break;
+    }
+
+    vpxt_mutex_unlock(&sweep->lock);
+}
+
+void vpxt_sweep_run(VPXT_SWEEP *sweep, vpxt_sweep_fn_t fn, void *arg,
+                    int job_count, int *results)
+{
+    VPXT_PRINT_CAPTURE *captures = NULL;
+
+    if (job_count < 1)
+        return;
+
+    // jobs running inline can print straight away
+    if (sweep->pool.thread_count > 0)
+        captures = new VPXT_PRINT_CAPTURE[job_count];
+
+    sweep->fn = fn;
+    sweep->arg = arg;
+    sweep->results = results;
+    sweep->job_count = job_count;
+    sweep->done = (int *)calloc(job_count, sizeof(int));
+    sweep->captures = captures;
+    sweep->next_print = 0;
+
+    vpxt_pool_run(&sweep->pool, sweep_job, sweep, job_count);
+
+    free(sweep->done);
+    delete [] captures;
+    sweep->done = NULL;
+    sweep->captures = NULL;
+}
+
+int vpxt_sweep_job_threads()
+{
+    return current_sweep ? current_sweep->pool.thread_count + 1 : 0;
+}
+
+void vpxt_timed_section_begin()
+{
+    VPXT_SWEEP *sweep = current_sweep;
+
+    if (!sweep || timed_depth++)
+        return;
+
+    vpxt_mutex_lock(&sweep->lock);
+    sweep->running--;
+    sweep->timing_waiting++;
+    vpxt_cond_broadcast(&sweep->changed);
+
+    while (sweep->timing || sweep->running)
+        vpxt_cond_wait(&sweep->changed, &sweep->lock);
+
+    sweep->timing_waiting--;
+    sweep->timing = 1;
+    vpxt_mutex_unlock(&sweep->lock);
+}
+
+void vpxt_timed_section_end()
+{
+    VPXT_SWEEP *sweep = current_sweep;
+
+    if (!sweep || --timed_depth)
+        return;
+
+    vpxt_mutex_lock(&sweep->lock);
+    sweep->timing = 0;
+    vpxt_cond_broadcast(&sweep->changed);
+    vpxt_mutex_unlock(&sweep->lock);
+
+    // back to running like any other job
+    sweep_enter(sweep);
+}
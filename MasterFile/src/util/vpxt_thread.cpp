@@ -0,0 +1,460 @@
+#include "vpxt_thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+struct thread_start
+{
+    vpxt_thread_fn_t fn;
+    void *arg;
+};
+
+static DWORD WINAPI thread_trampoline(LPVOID param)
+{
+    thread_start start = *(thread_start *)param;
+
+    free(param);
+    start.fn(start.arg);
+
+    return 0;
+}
+#endif
+
+int vpxt_thread_create(vpxt_thread_t *thread, vpxt_thread_fn_t fn, void *arg)
+{
+#if defined(_WIN32)
+    thread_start *start = (thread_start *)malloc(sizeof(thread_start));
+
+    if (!start)
+        return -1;
+
+    start->fn = fn;
+    start->arg = arg;
+    *thread = CreateThread(NULL, 0, thread_trampoline, start, 0, NULL);
+
+    if (*thread == NULL)
+    {
+        free(start);
+        return -1;
+    }
+
+    return 0;
+#else
+    return pthread_create(thread, NULL, fn, arg) ? -1 : 0;
+#endif
+}
+
+int vpxt_thread_join(vpxt_thread_t thread)
+{
+#if defined(_WIN32)
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0)
+        return -1;
+
+    CloseHandle(thread);
+    return 0;
+#else
+    return pthread_join(thread, NULL) ? -1 : 0;
+#endif
+}
+
+void vpxt_mutex_init(vpxt_mutex_t *mutex)
+{
+#if defined(_WIN32)
+    InitializeCriticalSection(mutex);
+#else
+    pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+void vpxt_mutex_destroy(vpxt_mutex_t *mutex)
+{
+#if defined(_WIN32)
+    DeleteCriticalSection(mutex);
+#else
+    pthread_mutex_destroy(mutex);
+#endif
+}
+
+void vpxt_mutex_lock(vpxt_mutex_t *mutex)
+{
+#if defined(_WIN32)
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+void vpxt_mutex_unlock(vpxt_mutex_t *mutex)
+{
+#if defined(_WIN32)
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+void vpxt_cond_init(vpxt_cond_t *cond)
+{
+#if defined(_WIN32)
+    InitializeConditionVariable(cond);
+#else
+    pthread_cond_init(cond, NULL);
+#endif
+}
+
+void vpxt_cond_destroy(vpxt_cond_t *cond)
+{
+#if !defined(_WIN32)
+    pthread_cond_destroy(cond);
+#endif
+}
+
+void vpxt_cond_wait(vpxt_cond_t *cond, vpxt_mutex_t *mutex)
+{
+#if defined(_WIN32)
+    SleepConditionVariableCS(cond, mutex, INFINITE);
+#else
+    pthread_cond_wait(cond, mutex);
+#endif
+}
+
+void vpxt_cond_signal(vpxt_cond_t *cond)
+{
+#if defined(_WIN32)
+    WakeConditionVariable(cond);
+#else
+    pthread_cond_signal(cond);
+#endif
+}
+
+void vpxt_cond_broadcast(vpxt_cond_t *cond)
+{
+#if defined(_WIN32)
+    WakeAllConditionVariable(cond);
+#else
+    pthread_cond_broadcast(cond);
+#endif
+}
+
+#if defined(_WIN32)
+static BOOL CALLBACK once_trampoline(PINIT_ONCE once, PVOID param,
+                                     PVOID *context)
+{
+    ((void (*)())param)();
+
+    return TRUE;
+}
+#endif
+
+void vpxt_once(vpxt_once_t *once, void (*fn)())
+{
+#if defined(_WIN32)
+    InitOnceExecuteOnce(once, once_trampoline, (PVOID)fn, NULL);
+#else
+    pthread_once(once, fn);
+#endif
+}
+
+int vpxt_cpu_count()
+{
+    int count = 1;
+
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    count = (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    return count < 1 ? 1 : count;
+}
+
+int vpxt_thread_pin(int first_cpu, int cpu_count)
+{
+    int count = vpxt_cpu_count();
+    int i;
+
+    if (first_cpu < 0)
+    {
+        first_cpu = 0;
+        cpu_count = count;
+    }
+
+    if (first_cpu >= count)
+        return -1;
+
+    if (cpu_count < 1)
+        cpu_count = 1;
+
+    if (first_cpu + cpu_count > count)
+        cpu_count = count - first_cpu;
+
+#if defined(_WIN32)
+    DWORD_PTR mask = 0;
+
+    for (i = first_cpu; i < first_cpu + cpu_count && i < 64; i++)
+        mask |= (DWORD_PTR)1 << i;
+
+    return SetThreadAffinityMask(GetCurrentThread(), mask) ? 0 : -1;
+#elif defined(linux) || defined(__linux__)
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+
+    for (i = first_cpu; i < first_cpu + cpu_count && i < CPU_SETSIZE; i++)
+        CPU_SET(i, &set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) ? -1 : 0;
+#else
+    return -1;
+#endif
+}
+
+int vpxt_thread_affinity_save(VPXT_AFFINITY *affinity)
+{
+    affinity->saved = 0;
+
+#if defined(_WIN32)
+    DWORD_PTR process_mask;
+    DWORD_PTR system_mask;
+
+    // there is no getter, setting the thread's mask returns the old one
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask,
+        &system_mask))
+        return -1;
+
+    affinity->mask = SetThreadAffinityMask(GetCurrentThread(), process_mask);
+
+    if (!affinity->mask)
+        return -1;
+
+    SetThreadAffinityMask(GetCurrentThread(), affinity->mask);
+    affinity->saved = 1;
+
+    return 0;
+#elif defined(linux) || defined(__linux__)
+    if (pthread_getaffinity_np(pthread_self(), sizeof(affinity->set),
+        &affinity->set))
+        return -1;
+
+    affinity->saved = 1;
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+int vpxt_thread_affinity_restore(const VPXT_AFFINITY *affinity)
+{
+    if (!affinity->saved)
+        return -1;
+
+#if defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), affinity->mask) ? 0 : -1;
+#elif defined(linux) || defined(__linux__)
+    return pthread_setaffinity_np(pthread_self(), sizeof(affinity->set),
+        &affinity->set) ? -1 : 0;
+#else
+    return -1;
+#endif
+}
+
+// Takes jobs from the current run until none are left.  Called with the
+// pool lock held and returns with it held.
+static void pool_work(VPXT_WORKER_POOL *pool)
+{
+    while (pool->next_job < pool->job_count)
+    {
+        int job = pool->next_job++;
+        vpxt_job_fn_t fn = pool->fn;
+        void *arg = pool->arg;
+
+        pool->jobs_running++;
+        vpxt_mutex_unlock(&pool->lock);
+
+        fn(arg, job);
+
+        vpxt_mutex_lock(&pool->lock);
+        pool->jobs_running--;
+    }
+
+    if (pool->jobs_running == 0)
+        vpxt_cond_broadcast(&pool->work_done);
+}
+
+static void *pool_thread(void *arg)
+{
+    VPXT_WORKER_POOL *pool = (VPXT_WORKER_POOL *)arg;
+    int generation = 0;
+
+    vpxt_mutex_lock(&pool->lock);
+
+    for (;;)
+    {
+        while (!pool->shutdown && generation == pool->generation)
+            vpxt_cond_wait(&pool->work_ready, &pool->lock);
+
+        if (pool->shutdown)
+            break;
+
+        generation = pool->generation;
+        pool_work(pool);
+    }
+
+    vpxt_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+int vpxt_pool_create(VPXT_WORKER_POOL *pool, int thread_count)
+{
+    int i;
+
+    memset(pool, 0, sizeof(*pool));
+    vpxt_mutex_init(&pool->lock);
+    vpxt_cond_init(&pool->work_ready);
+    vpxt_cond_init(&pool->work_done);
+
+    if (thread_count <= 0)
+        return 0;
+
+    pool->threads = (vpxt_thread_t *)malloc(thread_count *
+        sizeof(vpxt_thread_t));
+
+    if (!pool->threads)
+        return -1;
+
+    for (i = 0; i < thread_count; i++)
+    {
+        if (vpxt_thread_create(&pool->threads[i], pool_thread, pool))
+            break;
+
+        pool->thread_count++;
+    }
+
+    return pool->thread_count == thread_count ? 0 : -1;
+}
+
+void vpxt_pool_run(VPXT_WORKER_POOL *pool, vpxt_job_fn_t fn, void *arg,
+                   int job_count)
+{
+    vpxt_mutex_lock(&pool->lock);
+
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->job_count = job_count;
+    pool->next_job = 0;
+    pool->generation++;
+
+    if (pool->thread_count && job_count > 1)
+        vpxt_cond_broadcast(&pool->work_ready);
+
+    pool_work(pool);
+
+    while (pool->next_job < pool->job_count || pool->jobs_running)
+        vpxt_cond_wait(&pool->work_done, &pool->lock);
+
+    vpxt_mutex_unlock(&pool->lock);
+}
+
+void vpxt_pool_destroy(VPXT_WORKER_POOL *pool)
+{
+    int i;
+
+    vpxt_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    vpxt_cond_broadcast(&pool->work_ready);
+    vpxt_mutex_unlock(&pool->lock);
+
+    for (i = 0; i < pool->thread_count; i++)
+        vpxt_thread_join(pool->threads[i]);
+
+    free(pool->threads);
+    vpxt_cond_destroy(&pool->work_ready);
+    vpxt_cond_destroy(&pool->work_done);
+    vpxt_mutex_destroy(&pool->lock);
+    memset(pool, 0, sizeof(*pool));
+}
+
+int vpxt_queue_init(VPXT_QUEUE *queue, int capacity)
+{
+    memset(queue, 0, sizeof(*queue));
+    vpxt_mutex_init(&queue->lock);
+    vpxt_cond_init(&queue->not_empty);
+    vpxt_cond_init(&queue->not_full);
+
+    queue->items = (void **)malloc(capacity * sizeof(void *));
+
+    if (!queue->items)
+        return -1;
+
+    queue->capacity = capacity;
+    return 0;
+}
+
+int vpxt_queue_push(VPXT_QUEUE *queue, void *item)
+{
+    vpxt_mutex_lock(&queue->lock);
+
+    while (!queue->closed && queue->count == queue->capacity)
+        vpxt_cond_wait(&queue->not_full, &queue->lock);
+
+    if (queue->closed)
+    {
+        vpxt_mutex_unlock(&queue->lock);
+        return -1;
+    }
+
+    queue->items[(queue->head + queue->count) % queue->capacity] = item;
+    queue->count++;
+    vpxt_cond_signal(&queue->not_empty);
+    vpxt_mutex_unlock(&queue->lock);
+
+    return 0;
+}
+
+int vpxt_queue_pop(VPXT_QUEUE *queue, void **item)
+{
+    vpxt_mutex_lock(&queue->lock);
+
+    while (!queue->closed && queue->count == 0)
+        vpxt_cond_wait(&queue->not_empty, &queue->lock);
+
+    if (queue->closed)
+    {
+        vpxt_mutex_unlock(&queue->lock);
+        return -1;
+    }
+
+    *item = queue->items[queue->head];
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->count--;
+    vpxt_cond_signal(&queue->not_full);
+    vpxt_mutex_unlock(&queue->lock);
+
+    return 0;
+}
+
+void vpxt_queue_close(VPXT_QUEUE *queue)
+{
+    vpxt_mutex_lock(&queue->lock);
+    queue->closed = 1;
+    vpxt_cond_broadcast(&queue->not_empty);
+    vpxt_cond_broadcast(&queue->not_full);
+    vpxt_mutex_unlock(&queue->lock);
+}
+
+void vpxt_queue_destroy(VPXT_QUEUE *queue)
+{
+    free(queue->items);
+    vpxt_cond_destroy(&queue->not_empty);
+    vpxt_cond_destroy(&queue->not_full);
+    vpxt_mutex_destroy(&queue->lock);
+    memset(queue, 0, sizeof(*queue));
+}
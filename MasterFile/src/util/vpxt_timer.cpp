@@ -0,0 +1,228 @@
+#include "vpxt_timer.h"
+#include <string.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+#if defined(_WIN32)
+// FILETIME counts 100 nanosecond units
+static uint64_t filetime_us(const FILETIME *time)
+{
+    return (((uint64_t)time->dwHighDateTime << 32) | time->dwLowDateTime) /
+        10;
+}
+#else
+static uint64_t timespec_us(const struct timespec *time)
+{
+    return (uint64_t)time->tv_sec * 1000000 + time->tv_nsec / 1000;
+}
+
+static uint64_t rusage_us(int who)
+{
+    struct rusage usage;
+
+    if (getrusage(who, &usage))
+        return 0;
+
+    return (uint64_t)usage.ru_utime.tv_sec * 1000000 +
+        usage.ru_utime.tv_usec + (uint64_t)usage.ru_stime.tv_sec * 1000000 +
+        usage.ru_stime.tv_usec;
+}
+#endif
+
+uint64_t vpxt_wall_time_us()
+{
+#if defined(_WIN32)
+    LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+
+    if (!QueryPerformanceFrequency(&freq) || !QueryPerformanceCounter(&count))
+        return (uint64_t)GetTickCount() * 1000;
+
+    // split to keep count * 1000000 from overflowing
+    return (uint64_t)(count.QuadPart / freq.QuadPart) * 1000000 +
+        (uint64_t)(count.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart;
+#else
+#if defined(CLOCK_MONOTONIC)
+    struct timespec now;
+
+    if (!clock_gettime(CLOCK_MONOTONIC, &now))
+        return timespec_us(&now);
+#endif
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
+
+uint64_t vpxt_thread_cpu_time_us()
+{
+#if defined(_WIN32)
+    FILETIME creation_time;
+    FILETIME exit_time;
+    FILETIME kernel_time;
+    FILETIME user_time;
+
+    if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time,
+        &kernel_time, &user_time))
+        return 0;
+
+    return filetime_us(&kernel_time) + filetime_us(&user_time);
+#else
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec now;
+
+    if (!clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now))
+        return timespec_us(&now);
+#endif
+#if defined(RUSAGE_THREAD)
+    return rusage_us(RUSAGE_THREAD);
+#else
+    return rusage_us(RUSAGE_SELF);
+#endif
+#endif
+}
+
+uint64_t vpxt_process_cpu_time_us()
+{
+#if defined(_WIN32)
+    FILETIME creation_time;
+    FILETIME exit_time;
+    FILETIME kernel_time;
+    FILETIME user_time;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time,
+        &kernel_time, &user_time))
+        return 0;
+
+    return filetime_us(&kernel_time) + filetime_us(&user_time);
+#else
+#if defined(CLOCK_PROCESS_CPUTIME_ID)
+    struct timespec now;
+
+    if (!clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now))
+        return timespec_us(&now);
+#endif
+    return rusage_us(RUSAGE_SELF);
+#endif
+}
+
+void vpxt_times_clear(VPXT_TIMES *times)
+{
+    memset(times, 0, sizeof(*times));
+}
+
+void vpxt_times_now(VPXT_TIMES *times)
+{
+    times->wall = vpxt_wall_time_us();
+    times->thread_cpu = vpxt_thread_cpu_time_us();
+    times->process_cpu = vpxt_process_cpu_time_us();
+}
+
+void vpxt_times_add_since(VPXT_TIMES *total, const VPXT_TIMES *start)
+{
+    VPXT_TIMES now;
+
+    vpxt_times_now(&now);
+    total->wall += now.wall - start->wall;
+    total->thread_cpu += now.thread_cpu - start->thread_cpu;
+    total->process_cpu += now.process_cpu - start->process_cpu;
+}
+
+// Bucket of value: exact below VPXT_LATENCY_EXACT, above that the top six
+// bits select the bucket within each power of two.
+static int latency_bucket(uint64_t value)
+{
+    int msb = 0;
+    int shift;
+
+    if (value < VPXT_LATENCY_EXACT)
+        return (int)value;
+
+    while (msb < 63 && value >> (msb + 1))
+        msb++;
+
+    shift = msb - 5;
+
+    return VPXT_LATENCY_EXACT + (msb - 6) * VPXT_LATENCY_SUB +
+        (int)(value >> shift) - VPXT_LATENCY_SUB;
+}
+
+// Largest value that falls in bucket.
+static uint64_t latency_bucket_value(int bucket)
+{
+    int msb;
+    uint64_t mantissa;
+
+    if (bucket < VPXT_LATENCY_EXACT)
+        return bucket;
+
+    bucket -= VPXT_LATENCY_EXACT;
+    msb = bucket / VPXT_LATENCY_SUB + 6;
+    mantissa = bucket % VPXT_LATENCY_SUB + VPXT_LATENCY_SUB;
+
+    return ((mantissa + 1) << (msb - 5)) - 1;
+}
+
+void vpxt_latency_clear(VPXT_LATENCY_HISTOGRAM *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+}
+
+void vpxt_latency_add(VPXT_LATENCY_HISTOGRAM *hist, uint64_t value)
+{
+    if (!hist->count || value < hist->min)
+        hist->min = value;
+
+    if (value > hist->max)
+        hist->max = value;
+
+    hist->count++;
+    hist->total += value;
+    hist->buckets[latency_bucket(value)]++;
+}
+
+uint64_t vpxt_latency_percentile(const VPXT_LATENCY_HISTOGRAM *hist,
+                                 double percentile)
+{
+    uint64_t target;
+    uint64_t seen = 0;
+    int i;
+
+    if (!hist->count)
+        return 0;
+
+    if (percentile >= 100)
+        return hist->max;
+
+    target = (uint64_t)(percentile * hist->count / 100);
+
+    if (target < 1 || target * 100 < percentile * hist->count)
+        target++;
+
+    for (i = 0; i < VPXT_LATENCY_BUCKETS; i++)
+    {
+        seen += hist->buckets[i];
+
+        if (seen >= target)
+        {
+            uint64_t value = latency_bucket_value(i);
+            return value < hist->max ? value : hist->max;
+        }
+    }
+
+    return hist->max;
+}
+
+uint64_t vpxt_latency_mean(const VPXT_LATENCY_HISTOGRAM *hist)
+{
+    return hist->count ? hist->total / hist->count : 0;
+}